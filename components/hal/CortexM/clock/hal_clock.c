@@ -0,0 +1,204 @@
+/** 
+  ******************************************************************************
+  *  @file   CortexM/clock/hal_clock.c
+  *  @brief  Tickless idle support for SysTick timer.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(HAL_CLOCK)
+#include FX_INTERFACE(HW_CPU)
+#include FX_INTERFACE(LANG_TYPES)
+#include FX_INTERFACE(FX_TIMER_INTERNAL)
+
+FX_METADATA(({ implementation: [HAL_CLOCK, ARMv7M_V1] }))
+
+//!
+//! SysTick registers.
+//!
+typedef volatile struct
+{
+    uint32_t CSR;     //!< Control and Status Register.
+    uint32_t RVR;     //!< Reload Value Register.
+    uint32_t CVR;     //!< Current Value Register.
+    uint32_t CALIB;   //!< Calibration Value Register.
+}
+hal_clock_systick_t;
+
+#define HAL_CLOCK_SYSTICK ((hal_clock_systick_t*) 0xE000E010)
+#define HAL_CLOCK_SYSTICK_ENABLE (1U << 0)
+#define HAL_CLOCK_SYSTICK_MAX (0x00FFFFFFU)
+#define HAL_CLOCK_ICSR ((volatile uint32_t*) 0xE000ED04)
+#define HAL_CLOCK_ICSR_PENDSTSET (1U << 26)
+
+//
+// Interrupt time accounting. Ticks credited after tickless idle are processed
+// in the idle thread, but this is tick handler's work, so, it is accounted as
+// interrupt time.
+//
+#if defined FX_THREAD_CPU_STATS
+extern void fx_thread_intr_enter(void);
+extern void fx_thread_intr_exit(void);
+#else
+#define fx_thread_intr_enter()
+#define fx_thread_intr_exit()
+#endif
+
+#if !defined HW_CPU_CYCLE_COUNTER
+
+//!
+//! Cycle counter fallback for cores without DWT cycle counter.
+//! Tick count is obtained via FX_TIMER_INTERNAL interface.
+//! If SysTick has expired but its interrupt is not handled yet, the tick 
+//! counter is behind the SysTick, so, pending tick is taken into account and 
+//! SysTick value is read again (since it may be reloaded after the first 
+//! read).
+//! @return SysTick clocks elapsed since the system start (modulo 2^32).
+//!
+uint32_t
+hal_clock_get_cycles(void)
+{
+    hal_clock_systick_t* const systick = HAL_CLOCK_SYSTICK;
+    const uint32_t period = systick->RVR + 1;
+    uint32_t ticks = fx_timer_get_tick_count();
+    uint32_t current = systick->CVR;
+
+    if (*HAL_CLOCK_ICSR & HAL_CLOCK_ICSR_PENDSTSET)
+    {
+        ++ticks;
+        current = systick->CVR;
+    }
+
+    return ticks * period + (period - 1 - current);
+}
+
+#endif
+
+//!
+//! Idle function.
+//! Reload value of SysTick programmed by the application is used as the tick
+//! period. When tickless mode is enabled, SysTick is stopped and restarted
+//! with the period which covers all ticks until the nearest timer deadline.
+//! If the CPU is woken up earlier by another interrupt, number of completed
+//! tick periods is credited to the tick counter and SysTick is restarted to
+//! expire at the next tick boundary, so, tick phase is preserved.
+//! @remark Application tick hook (if enabled) is not called for skipped ticks.
+//!
+void
+hal_clock_idle(void)
+{
+#if defined HAL_CLOCK_TICKLESS
+    hal_clock_systick_t* const systick = HAL_CLOCK_SYSTICK;
+    uint32_t period, remaining, idle, reload, current, next;
+    uint32_t elapsed = 0;
+
+    //
+    // Interrupts are disabled using PRIMASK, since WFI wakes the CPU up even
+    // if pending interrupt is masked by PRIMASK. Interrupt handlers will be
+    // called after the tick counter is updated.
+    //
+    hw_cpu_intr_disable();
+
+    period = systick->RVR + 1;
+    remaining = systick->CVR ? systick->CVR : period;
+
+    idle = (*HAL_CLOCK_ICSR & HAL_CLOCK_ICSR_PENDSTSET) ? 0 :
+        fx_tick_get_idle((HAL_CLOCK_SYSTICK_MAX - remaining) / period);
+
+    if (idle == 0)
+    {
+        hw_cpu_idle();
+        hw_cpu_intr_enable();
+        return;
+    }
+
+    //
+    // Stop the counter and get remaining part of current tick. Zero value 
+    // means that counter has not been loaded yet after restart, so, whole tick
+    // period remains. If tick boundary has been crossed while idle ticks were
+    // being calculated, just return and let SysTick handler process the tick.
+    //
+    systick->CSR &= ~HAL_CLOCK_SYSTICK_ENABLE;
+    remaining = systick->CVR ? systick->CVR : period;
+
+    if (*HAL_CLOCK_ICSR & HAL_CLOCK_ICSR_PENDSTSET)
+    {
+        systick->CSR |= HAL_CLOCK_SYSTICK_ENABLE;
+        hw_cpu_intr_enable();
+        return;
+    }
+
+    //
+    // Remaining part of current tick and all the idle ticks. SysTick interrupt
+    // will occur at the boundary of the tick when the nearest timer expires.
+    //
+    reload = remaining + idle * period;
+    systick->RVR = reload - 1;
+    systick->CVR = 0;
+    systick->CSR |= HAL_CLOCK_SYSTICK_ENABLE;
+
+    hw_cpu_idle();
+
+    systick->CSR &= ~HAL_CLOCK_SYSTICK_ENABLE;
+    current = systick->CVR;
+
+    if (*HAL_CLOCK_ICSR & HAL_CLOCK_ICSR_PENDSTSET)
+    {
+        //
+        // Whole idle period is elapsed, the last tick will be handled by the
+        // pending SysTick interrupt. Counter is reloaded after expiration,
+        // so, it contains time elapsed since tick boundary.
+        //
+        elapsed = idle;
+        next = period - (current ? (reload - 1 - current) % period : 0);
+    }
+    else
+    {
+        //
+        // CPU is woken up by other interrupt. Credit completed ticks and
+        // restart SysTick at the next tick boundary.
+        //
+        const uint32_t counted = current ? reload - current : 0;
+
+        if (counted >= remaining)
+        {
+            elapsed = (counted - remaining) / period + 1;
+        }
+
+        next = remaining + elapsed * period - counted;
+    }
+
+    systick->RVR = next - 1;
+    systick->CVR = 0;
+    systick->CSR |= HAL_CLOCK_SYSTICK_ENABLE;
+    systick->RVR = period - 1;
+
+    fx_thread_intr_enter();
+    fx_tick_advance(elapsed);
+    fx_thread_intr_exit();
+    hw_cpu_intr_enable();
+#else
+    hw_cpu_idle();
+#endif
+}
@@ -31,12 +31,40 @@
   *****************************************************************************/
 
 #include FX_INTERFACE(CFG_OPTIONS)
+#include FX_INTERFACE(LANG_TYPES)
+#include FX_INTERFACE(HW_CPU)
+
+//!
+//! Idle function. It is called by the idle thread instead of hw_cpu_idle.
+//! In tickless mode SysTick is reprogrammed to expire at the nearest timer
+//! deadline, so, the CPU is not woken up by ticks while the system is idle.
+//!
+void hal_clock_idle(void);
+
+//!
+//! Free-running 32-bit cycle counter used for execution time measurement. 
+//! DWT cycle counter is used if the core has it. Otherwise the counter is 
+//! derived from tick count and SysTick current value, so, it counts SysTick
+//! clocks and assumes constant reload value (in tickless mode time spent in 
+//! the idle thread is measured approximately).
+//! @remark Fallback implementation must be called with interrupts disabled.
+//!
+#if defined HW_CPU_CYCLE_COUNTER
+#define hal_clock_cycles_init() hw_cpu_cycles_enable()
+#define hal_clock_get_cycles() hw_cpu_get_cycles()
+#else
+#define hal_clock_cycles_init()
+uint32_t hal_clock_get_cycles(void);
+#endif
   
 FX_METADATA(({ interface: [HAL_CLOCK, ARMv7M_V1] }))
 
 FX_METADATA(({ options: [                                               
     HAL_CLOCK_TICK_HOOK: {                                                    
         type: int, range: [0, 1], default: 0,                        
-        description: "Call application function in HAL tick."}]}))
+        description: "Call application function in HAL tick."},
+    HAL_CLOCK_TICKLESS: {                                                    
+        type: int, range: [0, 1], default: 0,                        
+        description: "Suppress SysTick interrupts when idle."}]}))
                 
 #endif
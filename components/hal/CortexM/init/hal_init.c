@@ -32,6 +32,7 @@
 #include FX_INTERFACE(HAL_ASYNC)
 #include FX_INTERFACE(CFG_OPTIONS)
 #include FX_INTERFACE(HW_CPU)
+#include FX_INTERFACE(HAL_CLOCK)
 
 FX_METADATA(({ implementation: [HAL_INIT, ARMv7M_LIB] }))
 
@@ -75,5 +76,5 @@ fx_kernel_entry(void)
     //
     // Use current control flow as idle-thread.
     //
-    for (;;)  hw_cpu_idle();
+    for (;;)  hal_clock_idle();
 }
@@ -0,0 +1,86 @@
+#ifndef _HAL_ASYNC_ARMv7M_BASEPRI_HEADER_
+#define _HAL_ASYNC_ARMv7M_BASEPRI_HEADER_
+
+/** 
+  ******************************************************************************
+  *  @file   CortexM/sync/basepri/hal_async.h
+  *  @brief  SPL management functions for unified interrupt architecture.
+  *  Kernel synchronization uses BASEPRI instead of PRIMASK, so interrupts with
+  *  priority above the kernel ceiling are never masked by the kernel. Such 
+  *  interrupts must not use kernel services. Available on ARMv7-M and 
+  *  ARMv8-M Mainline only.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(LANG_TYPES)
+#include FX_INTERFACE(CFG_OPTIONS)
+
+#ifndef HAL_ASYNC_BASEPRI_CEILING
+#define HAL_ASYNC_BASEPRI_CEILING 0x20
+#endif
+
+FX_METADATA(({ interface: [HAL_ASYNC, ARMv7M_BASEPRI] }))
+
+//!
+//! Constants for SPL levels. These constants are tightly coupled with BASEPRI 
+//! register format, so, they must not be changed! All OS-managed interrupts
+//! (including SysTick) must have priority values not less than the ceiling.
+//! The ceiling must be representable using implemented priority bits of the
+//! particular MCU (unimplemented low-order bits are read as zero).
+//! In segmented scheme DISPATCH is the lowest BASEPRI priority which masks 
+//! PendSV only, so, OS-managed interrupts must also have priority higher than 
+//! PendSV. Since unimplemented low-order bits of BASEPRI are read as zero, 
+//! DISPATCH level is reported for any value between the ceiling and the 
+//! lowest priority.
+//!
+typedef enum
+{
+    SPL_SYNC = HAL_ASYNC_BASEPRI_CEILING,
+#if defined HAL_ASYNC_SEGMENTED
+    SPL_DISPATCH = 0xFF,
+#else
+    SPL_DISPATCH = SPL_SYNC,
+#endif
+    SPL_LOW = 0x00
+}
+spl_t;
+
+void hal_async_ctor(void);
+spl_t hal_async_raise_spl(const spl_t new_spl); 
+void hal_async_lower_spl(const spl_t new_spl);
+spl_t hal_async_get_current_spl(void);
+
+#define ICSR_ADDR ((volatile unsigned int*) 0xE000ED04)
+#define hal_async_request_swi(spl) ((*ICSR_ADDR) = 0x10000000)
+
+FX_METADATA(({ options: [                                               
+    HAL_ASYNC_BASEPRI_CEILING: {                                                    
+        type: int, range: [0x01, 0xFF], default: 0x20,                        
+        description: "BASEPRI value used for kernel synchronization."},
+    HAL_ASYNC_SEGMENTED: {
+        type: int, range: [0, 1], default: 0,
+        description: "Separate DISPATCH level for segmented scheme."}]}))
+                
+#endif
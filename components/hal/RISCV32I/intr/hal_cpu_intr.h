@@ -33,6 +33,7 @@
 
 #include FX_INTERFACE(CFG_OPTIONS)
 #include FX_INTERFACE(LANG_TYPES)
+#include FX_INTERFACE(HW_CPU)
 
 //!
 //! SPL level constants. All ISRs use single level, interrupts priority are
@@ -82,6 +83,9 @@ spl_t hal_async_raise_spl(const spl_t spl);
 void hal_async_lower_spl(const spl_t spl);
 spl_t hal_async_get_current_spl(void);
 void hal_async_request_swi(spl_t spl);
+void hal_clock_idle(void);
+#define hal_clock_cycles_init() hw_cpu_cycles_enable()
+#define hal_clock_get_cycles() hw_cpu_get_cycles()
 
 //------------------------------------------------------------------------------
 
@@ -92,6 +96,18 @@ FX_METADATA(({ interface: [HAL_CPU_INTR, RV32I] }))
 FX_METADATA(({ options: [                                                                           
     HAL_INTR_STACK_SIZE: {                                                        
         type: int, range: [0x100, 0xffffffff], default: 0x1000,                     
-        description: "Size of the interrupt stack (in bytes)."}]}))
+        description: "Size of the interrupt stack (in bytes)."},
+    HAL_INTR_TICKLESS: {                                                        
+        type: int, range: [0, 1], default: 0,                     
+        description: "Suppress timer interrupts while the system is idle."},
+    HAL_INTR_MTIME_ADDR: {
+        type: int, range: [0, 0xffffffff], default: 0x0200BFF8,
+        description: "Address of mtime register (tickless mode)."},
+    HAL_INTR_MTIMECMP_ADDR: {
+        type: int, range: [0, 0xffffffff], default: 0x02004000,
+        description: "Address of mtimecmp register (tickless mode)."},
+    HAL_INTR_TICK_PERIOD: {
+        type: int, range: [0, 0xffffffff], default: 0,
+        description: "Tick period in mtime units (tickless mode)."}]}))
 
 #endif
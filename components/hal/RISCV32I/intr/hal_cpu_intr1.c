@@ -30,6 +30,7 @@
 
 #include FX_INTERFACE(HAL_CPU_INTR)
 #include FX_INTERFACE(HW_CPU)
+#include FX_INTERFACE(FX_TIMER_INTERNAL)
 
 FX_METADATA(({ implementation: [HAL_CPU_INTR, RV32I] }))
 
@@ -43,6 +44,45 @@ extern void hal_intr_check_swi(void);
 extern void hal_timer_pre_tick(void);
 extern void hal_timer_post_tick(void);
 
+//
+// Tickless mode uses machine timer registers directly. The board must use 
+// mtimecmp to generate periodic ticks and the tick period must be specified.
+//
+#if defined HAL_INTR_TICKLESS
+
+#ifndef HAL_INTR_MTIME_ADDR
+#define HAL_INTR_MTIME_ADDR 0x0200BFF8
+#endif
+
+#ifndef HAL_INTR_MTIMECMP_ADDR
+#define HAL_INTR_MTIMECMP_ADDR 0x02004000
+#endif
+
+#if !defined HAL_INTR_TICK_PERIOD || (HAL_INTR_TICK_PERIOD == 0)
+#error "Tickless mode requires HAL_INTR_TICK_PERIOD (mtime units per tick)"
+#endif
+
+#define HAL_INTR_MTIME ((volatile uint32_t*) (HAL_INTR_MTIME_ADDR))
+#define HAL_INTR_MTIMECMP ((volatile uint32_t*) (HAL_INTR_MTIMECMP_ADDR))
+
+//
+// Tick boundary which was pending when the timer interrupt was postponed.
+//
+static uint64_t g_hal_intr_idle_next = 0;
+
+#endif
+
+//
+// Interrupt time accounting. ISR duration is charged to interrupted thread.
+//
+#if defined FX_THREAD_CPU_STATS
+extern void fx_thread_intr_enter(void);
+extern void fx_thread_intr_exit(void);
+#else
+#define fx_thread_intr_enter()
+#define fx_thread_intr_exit()
+#endif
+
 static inline spl_t
 _hal_async_spl_set(const spl_t spl)
 {
@@ -120,6 +160,134 @@ hal_async_request_swi(spl_t spl)
     hw_cpu_dmb();
 }
 
+#if defined HAL_INTR_TICKLESS
+
+//
+// Reads 64-bit machine timer. High word is read twice in order to detect low 
+// word overflow between reads.
+//
+static uint64_t
+hal_timer_get_mtime(void)
+{
+    uint32_t hi;
+    uint32_t lo;
+
+    do
+    {
+        hi = HAL_INTR_MTIME[1];
+        lo = HAL_INTR_MTIME[0];
+    }
+    while (hi != HAL_INTR_MTIME[1]);
+
+    return ((uint64_t) hi << 32) | lo;
+}
+
+//
+// Sets the timer comparator. Low word is set to maximum first, so, no 
+// spurious interrupt is caused by intermediate value.
+//
+static void
+hal_timer_set_mtimecmp(uint64_t value)
+{
+    HAL_INTR_MTIMECMP[0] = UINT32_MAX;
+    HAL_INTR_MTIMECMP[1] = (uint32_t) (value >> 32);
+    HAL_INTR_MTIMECMP[0] = (uint32_t) value;
+}
+
+//
+// Postpones next timer interrupt by given number of ticks. The number is 
+// limited in order to keep the sleep interval within 32 bits. 
+// @return Actual number of postponed ticks, 0 if the tick is already pending.
+//
+static uint32_t
+hal_timer_idle_enter(uint32_t ticks)
+{
+    const uint32_t max = UINT32_MAX / HAL_INTR_TICK_PERIOD - 1;
+
+    g_hal_intr_idle_next = ((uint64_t) HAL_INTR_MTIMECMP[1] << 32) | 
+        HAL_INTR_MTIMECMP[0];
+
+    if (hal_timer_get_mtime() >= g_hal_intr_idle_next)
+    {
+        return 0;
+    }
+
+    ticks = lang_min(ticks, max);
+    hal_timer_set_mtimecmp(
+        g_hal_intr_idle_next + (uint64_t) ticks * HAL_INTR_TICK_PERIOD
+    );
+    return ticks;
+}
+
+//
+// Counts tick boundaries passed since the timer was postponed. If the CPU 
+// was woken up before the postponed interrupt, the timer is reprogrammed to 
+// the next tick boundary.
+// @param [in] ticks Number of postponed ticks.
+// @return Number of completed tick periods, not including the period whose 
+// expiration causes pending timer interrupt.
+//
+static uint32_t
+hal_timer_idle_exit(uint32_t ticks)
+{
+    const uint64_t now = hal_timer_get_mtime();
+    const uint64_t next = g_hal_intr_idle_next;
+    uint32_t passed = 0;
+
+    if (now >= next)
+    {
+        passed = (uint32_t) (now - next) / HAL_INTR_TICK_PERIOD + 1;
+    }
+
+    if (passed < ticks)
+    {
+        hal_timer_set_mtimecmp(next + (uint64_t) passed * HAL_INTR_TICK_PERIOD);
+        return passed;
+    }
+
+    return ticks;
+}
+
+#endif
+
+//!
+//! Idle function. It is called by the idle thread instead of hw_cpu_idle.
+//! In tickless mode the machine timer is programmed to expire at the nearest 
+//! timer deadline, and ticks completed during the sleep are credited at once
+//! after wakeup. The final tick is handled by the regular timer interrupt.
+//!
+void
+hal_clock_idle(void)
+{
+#if defined HAL_INTR_TICKLESS
+    uint32_t idle;
+
+    //
+    // Raising SPL disables interrupts. WFI wakes the CPU up when interrupt is 
+    // pending, even if interrupts are globally disabled.
+    //
+    const spl_t prev_spl = hal_async_raise_spl(SPL_SYNC);
+
+    idle = fx_tick_get_idle(UINT32_MAX);
+
+    if (idle)
+    {
+        idle = hal_timer_idle_enter(idle);
+    }
+
+    hw_cpu_idle();
+
+    if (idle)
+    {
+        fx_tick_advance(hal_timer_idle_exit(idle));
+    }
+
+    hal_async_lower_spl(prev_spl);
+#else
+    hw_cpu_idle();
+#endif
+}
+
 //!
 //! Called from asm code at interrupt stack as hardware interrupt handler.
 //! It is always asynchronous and called with interrupts disabled.
@@ -130,6 +298,7 @@ void
 hal_intr_handler(uint32_t mcause)
 {
     const spl_t prev_spl = _hal_async_spl_set(SPL_ISR);
+    fx_thread_intr_enter();
 
     if ((mcause & HAL_INTR_MCAUSE_EXCCODE_MASK) == HAL_INTR_TIMER_MCAUSE)
     {
@@ -145,6 +314,7 @@ hal_intr_handler(uint32_t mcause)
     }
 
     hw_cpu_intr_disable();
+    fx_thread_intr_exit();
 
     if (prev_spl == SPL_LOW)
     {
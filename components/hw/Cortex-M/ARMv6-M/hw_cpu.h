@@ -114,9 +114,36 @@ unsigned int hw_cpu_atomic_add(volatile unsigned int* arg, unsigned int add);
 
 //
 // Helper functions for bit counting.
+// ARMv6-M has no CLZ instruction, so, de Bruijn multiplication is used in 
+// order to get bit position in constant time. Both functions return 32 for 
+// zero argument.
 //
-unsigned int hw_cpu_clz(unsigned int arg);
-unsigned int hw_cpu_ctz(unsigned int arg);
+static inline unsigned int
+hw_cpu_clz(unsigned int arg)
+{
+    static const uint8_t pos[32] = 
+    {
+        0, 9, 1, 10, 13, 21, 2, 29, 11, 14, 16, 18, 22, 25, 3, 30,
+        8, 12, 20, 28, 15, 17, 24, 7, 19, 27, 23, 6, 26, 5, 4, 31
+    };
+    arg |= arg >> 1;
+    arg |= arg >> 2;
+    arg |= arg >> 4;
+    arg |= arg >> 8;
+    arg |= arg >> 16;
+    return 31 - pos[(arg * 0x07C4ACDDU) >> 27] + (arg == 0);
+}
+
+static inline unsigned int
+hw_cpu_ctz(unsigned int arg)
+{
+    static const uint8_t pos[32] = 
+    {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+    return pos[((arg & (0U - arg)) * 0x077CB531U) >> 27] + ((arg == 0) << 5);
+}
 
 //!
 //! Place processor to implementation-specific low-power state until next 
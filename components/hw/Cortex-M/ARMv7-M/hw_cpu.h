@@ -64,6 +64,26 @@ hw_scb_t;
 #define HW_SYSTEM_CTL   ((hw_scb_t*) HW_CPU_SCB_BASE)
 #define hw_cpu_request_pendsv() HW_SYSTEM_CTL->ICSR = 0x10000000
 
+//
+// Cycle counter of the Data Watchpoint and Trace unit. It is started by 
+// enabling trace in DEMCR and setting CYCCNTENA bit. Lock access register is 
+// implemented on Cortex-M7 only, writes to it are ignored by other cores.
+//
+#define HW_CPU_CYCLE_COUNTER 1
+#define HW_CPU_DEMCR ((volatile uint32_t*) 0xE000EDFC)
+#define HW_CPU_DWT_CTRL ((volatile uint32_t*) 0xE0001000)
+#define HW_CPU_DWT_CYCCNT ((volatile uint32_t*) 0xE0001004)
+#define HW_CPU_DWT_LAR ((volatile uint32_t*) 0xE0001FB0)
+#define hw_cpu_get_cycles() (*HW_CPU_DWT_CYCCNT)
+
+static inline void
+hw_cpu_cycles_enable(void)
+{
+    *HW_CPU_DEMCR |= (1U << 24);
+    *HW_CPU_DWT_LAR = 0xC5ACCE55;
+    *HW_CPU_DWT_CTRL |= 1U;
+}
+
 //
 // CPU-specific instructions and registers reads/writes.
 //
@@ -148,10 +168,31 @@ unsigned int hw_cpu_atomic_add(volatile unsigned int* arg, unsigned int add);
 
 //
 // Helper functions for bit counting and BSR/BSF implementation.
+// Both functions return 32 for zero argument. GCC builtins are expanded into 
+// CLZ/RBIT instructions inline, assembly versions are used for other 
+// compilers.
 //
+#if defined __GNUC__
+
+static inline unsigned int
+hw_cpu_clz(unsigned int arg)
+{
+    return arg ? __builtin_clz(arg) : 32;
+}
+
+static inline unsigned int
+hw_cpu_ctz(unsigned int arg)
+{
+    return arg ? __builtin_ctz(arg) : 32;
+}
+
+#else
+
 unsigned int hw_cpu_clz(unsigned int arg);
 unsigned int hw_cpu_ctz(unsigned int arg);
 
+#endif
+
 //!
 //! Places processor to implementation-specific low-power state until next 
 //! interrupt occurs. 
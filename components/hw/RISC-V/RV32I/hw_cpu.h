@@ -124,9 +124,96 @@ unsigned int hw_cpu_atomic_add(volatile unsigned int* arg, unsigned int add);
 
 //
 // Helper functions for bit counting and BSR/BSF implementation.
+// Both functions return 32 for zero argument and take constant time. Zbb 
+// instructions are used if the extension is available, otherwise de Bruijn 
+// multiplication is used on cores with M extension. Base ISA has no fast 
+// multiplication, so, bit position is found by branchless binary search.
 //
-unsigned int hw_cpu_clz(unsigned int arg);
-unsigned int hw_cpu_ctz(unsigned int arg);
+#if defined __riscv_zbb
+
+static inline unsigned int
+hw_cpu_clz(unsigned int arg)
+{
+    return arg ? __builtin_clz(arg) : 32;
+}
+
+static inline unsigned int
+hw_cpu_ctz(unsigned int arg)
+{
+    return arg ? __builtin_ctz(arg) : 32;
+}
+
+#elif defined __riscv_mul
+
+static inline unsigned int
+hw_cpu_clz(unsigned int arg)
+{
+    static const uint8_t pos[32] = 
+    {
+        0, 9, 1, 10, 13, 21, 2, 29, 11, 14, 16, 18, 22, 25, 3, 30,
+        8, 12, 20, 28, 15, 17, 24, 7, 19, 27, 23, 6, 26, 5, 4, 31
+    };
+    arg |= arg >> 1;
+    arg |= arg >> 2;
+    arg |= arg >> 4;
+    arg |= arg >> 8;
+    arg |= arg >> 16;
+    return 31 - pos[(arg * 0x07C4ACDDU) >> 27] + (arg == 0);
+}
+
+static inline unsigned int
+hw_cpu_ctz(unsigned int arg)
+{
+    static const uint8_t pos[32] = 
+    {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+    return pos[((arg & (0U - arg)) * 0x077CB531U) >> 27] + ((arg == 0) << 5);
+}
+
+#else
+
+static inline unsigned int
+hw_cpu_clz(unsigned int arg)
+{
+    unsigned int n = 0, s = 0;
+    s = (arg < 0x00010000U) << 4; n += s; arg <<= s;
+    s = (arg < 0x01000000U) << 3; n += s; arg <<= s;
+    s = (arg < 0x10000000U) << 2; n += s; arg <<= s;
+    s = (arg < 0x40000000U) << 1; n += s; arg <<= s;
+    s = (arg < 0x80000000U); n += s; arg <<= s;
+    return n + (arg == 0);
+}
+
+static inline unsigned int
+hw_cpu_ctz(unsigned int arg)
+{
+    unsigned int n = 0, s = 0;
+    s = ((arg & 0xFFFF) == 0) << 4; n += s; arg >>= s;
+    s = ((arg & 0x00FF) == 0) << 3; n += s; arg >>= s;
+    s = ((arg & 0x000F) == 0) << 2; n += s; arg >>= s;
+    s = ((arg & 0x0003) == 0) << 1; n += s; arg >>= s;
+    s = ((arg & 0x0001) == 0); n += s; arg >>= s;
+    return n + (arg == 0);
+}
+
+#endif
+
+//
+// Cycle counter. Lower half of mcycle CSR is used, it is running after reset,
+// so, no initialization is needed.
+//
+#define HW_CPU_CYCLE_COUNTER 1
+#define hw_cpu_cycles_enable()
+
+static inline uint32_t
+hw_cpu_get_cycles(void)
+{
+    uint32_t cycles;
+    __asm__ volatile ("csrr %0, mcycle" : "=r" (cycles));
+    return cycles;
+}
 
 //!
 //! Places CPU to implementation-specific low-power state until next interrupt. 
@@ -0,0 +1,229 @@
+/** 
+  ******************************************************************************
+  *  @file   up/fx_dpc.c
+  *  @brief  Deferred procedure calls for uniprocessor systems.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(FX_DPC)
+#include FX_INTERFACE(FX_SPL)
+#include FX_INTERFACE(HAL_ASYNC)
+#include FX_INTERFACE(HAL_MP)
+
+FX_METADATA(({ implementation: [FX_DPC, UP_QUEUE] }))
+
+lang_static_assert(HAL_MP_CPU_MAX == 1);
+
+//
+// DPC queue is accessed by interrupt handlers, so, it is protected by raising
+// SPL to SYNC. Each importance level has its own FIFO queue. Environment flag
+// is set while deferred functions are called.
+//
+typedef struct
+{
+    rtl_list_t queue[FX_DPC_IMPORTANCE_MAX];
+    volatile bool active;
+}
+fx_dpc_context_t;
+
+static fx_dpc_context_t fx_dpc_context;
+#define fx_dpc_get_context() (&fx_dpc_context)
+
+//!
+//! DPC module initialization.
+//! @remark SPL = SYNC
+//!
+void
+fx_dpc_ctor(void)
+{
+    fx_dpc_context_t* const context = fx_dpc_get_context();
+    unsigned int i;
+
+    for (i = 0; i < FX_DPC_IMPORTANCE_MAX; ++i)
+    {
+        rtl_list_init(&context->queue[i]);
+    }
+
+    context->active = false;
+}
+
+//!
+//! DPC object initialization. DPC is initialized as low importance one.
+//! @param [in,out] dpc DPC object to be initialized (allocated by user).
+//!
+void
+fx_dpc_init(fx_dpc_t* dpc)
+{
+    dpc->link.next = dpc->link.prev = NULL;
+    dpc->func = NULL;
+    dpc->arg = NULL;
+    dpc->importance = FX_DPC_IMPORTANCE_LOW;
+}
+
+//!
+//! Sets DPC importance. New importance is used on next request.
+//! @param [in,out] dpc DPC object.
+//! @param [in] importance New importance of the DPC.
+//!
+void
+fx_dpc_set_importance(fx_dpc_t* dpc, fx_dpc_importance_t importance)
+{
+    fx_dbg_assert(importance < FX_DPC_IMPORTANCE_MAX);
+    dpc->importance = importance;
+}
+
+//!
+//! Inserts DPC into the queue and requests dispatch software interrupt.
+//! @param [in] dpc DPC object to be queued.
+//! @param [in] func Deferred function.
+//! @param [in] arg Argument to be passed into deferred function.
+//! @return true if DPC has been queued, false if it is already in the queue
+//! (in this case function and argument are not changed).
+//! @remark SPL <= SYNC
+//!
+bool
+fx_dpc_request(fx_dpc_t* dpc, void (*func)(fx_dpc_t*, void*), void* arg)
+{
+    fx_dpc_context_t* const context = fx_dpc_get_context();
+    bool queued = false;
+    fx_lock_intr_state_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+
+    if (!rtl_list_is_node_linked(&dpc->link))
+    {
+        rtl_list_t* const queue = &context->queue[dpc->importance];
+
+        dpc->func = func;
+        dpc->arg = arg;
+        rtl_list_insert(rtl_list_last(queue), &dpc->link);
+
+        //
+        // Dispatch interrupt is requested unconditionally, even if the queue 
+        // is being handled, it will be ignored if the queue is empty.
+        //
+        hal_async_request_swi(SPL_DISPATCH);
+        queued = true;
+    }
+
+    fx_spl_lower_to_any_from_sync(state);
+    return queued;
+}
+
+//!
+//! Removes DPC from the queue.
+//! @param [in] dpc DPC object to be cancelled.
+//! @return true if DPC has been removed from the queue, false if it was not
+//! queued (or it is being executed at the moment).
+//! @remark SPL <= SYNC
+//!
+bool
+fx_dpc_cancel(fx_dpc_t* dpc)
+{
+    bool cancelled = false;
+    fx_lock_intr_state_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+
+    if (rtl_list_is_node_linked(&dpc->link))
+    {
+        rtl_list_remove(&dpc->link);
+        cancelled = true;
+    }
+
+    fx_spl_lower_to_any_from_sync(state);
+    return cancelled;
+}
+
+//!
+//! Checks whether the caller is deferred function.
+//! @return true if DPC queue is being handled at the moment.
+//!
+bool
+fx_dpc_environment(void)
+{
+    return fx_dpc_get_context()->active;
+}
+
+//
+// Gets the first DPC from the most important non-empty queue.
+// @return DPC or NULL if all queues are empty.
+// @remark SPL = SYNC
+//
+static fx_dpc_t*
+fx_dpc_get_next(fx_dpc_context_t* context)
+{
+    unsigned int i;
+
+    for (i = 0; i < FX_DPC_IMPORTANCE_MAX; ++i)
+    {
+        if (!rtl_list_empty(&context->queue[i]))
+        {
+            return rtl_list_entry(
+                rtl_list_first(&context->queue[i]), 
+                fx_dpc_t, 
+                link
+            );
+        }
+    }
+
+    return NULL;
+}
+
+//!
+//! Calls all deferred functions in the queue (including ones which are queued
+//! while the queue is being handled). It is called by the dispatch software
+//! interrupt handler before rescheduling. High importance DPC queued by
+//! interrupt handler is called before remaining low importance ones.
+//! @remark SPL = DISPATCH
+//!
+void
+fx_dpc_handle_queue(void)
+{
+    fx_dpc_context_t* const context = fx_dpc_get_context();
+    fx_dpc_t* dpc;
+    fx_lock_intr_state_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+    context->active = true;
+
+    while ((dpc = fx_dpc_get_next(context)) != NULL)
+    {
+        void (* const func)(fx_dpc_t*, void*) = dpc->func;
+        void* const arg = dpc->arg;
+
+        //
+        // DPC is removed from the queue before the call, so, deferred function
+        // may request it again.
+        //
+        rtl_list_remove(&dpc->link);
+        fx_spl_lower_to_any_from_sync(state);
+        func(dpc, arg);
+        fx_spl_raise_to_sync_from_any(&state);
+    }
+
+    context->active = false;
+    fx_spl_lower_to_any_from_sync(state);
+}
@@ -0,0 +1,79 @@
+#ifndef _FX_DPC_UP_QUEUE_HEADER_
+#define _FX_DPC_UP_QUEUE_HEADER_
+
+/** 
+  ******************************************************************************
+  *  @file   up/fx_dpc.h
+  *  @brief  Deferred procedure calls for uniprocessor systems.
+  *  DPC requests are put into the queue which is handled by dispatch software
+  *  interrupt handler before rescheduling. Requests may be issued at any SPL,
+  *  including interrupt handlers. Requests issued before the queue is handled
+  *  are batched into single dispatch interrupt. High importance DPCs are 
+  *  called before low importance ones. This DPC implementation may be used 
+  *  with both unified and segmented synchronization schemes.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(LANG_TYPES)
+#include FX_INTERFACE(FX_DBG)
+#include FX_INTERFACE(RTL_LIST)
+
+//!
+//! DPC importance. DPCs with the same importance are called in FIFO order.
+//!
+typedef enum
+{
+    FX_DPC_IMPORTANCE_HIGH = 0,
+    FX_DPC_IMPORTANCE_LOW,
+    FX_DPC_IMPORTANCE_MAX
+}
+fx_dpc_importance_t;
+
+//!
+//! DPC object. It is allocated by the caller and must be initialized before
+//! the first request. DPC object must not be reinitialized while it is queued.
+//!
+typedef struct _fx_dpc_t
+{
+    rtl_list_linkage_t link;
+    void (*func)(struct _fx_dpc_t*, void*);
+    void* arg;
+    fx_dpc_importance_t importance;
+}
+fx_dpc_t;
+
+void fx_dpc_ctor(void);
+void fx_dpc_init(fx_dpc_t* dpc);
+void fx_dpc_set_importance(fx_dpc_t* dpc, fx_dpc_importance_t importance);
+bool fx_dpc_request(fx_dpc_t* dpc, void (*func)(fx_dpc_t*, void*), void* arg);
+bool fx_dpc_cancel(fx_dpc_t* dpc);
+bool fx_dpc_environment(void);
+void fx_dpc_handle_queue(void);
+
+#define fx_dpc_set_target_cpu(dpc, cpu) fx_dbg_assert(cpu == 0)
+
+FX_METADATA(({ interface: [FX_DPC, UP_QUEUE] }))
+
+#endif
@@ -0,0 +1,350 @@
+/** 
+  ******************************************************************************
+  *  @file   edf/fx_sched_alg.c
+  *  @brief  Implementation of earliest-deadline-first scheduler container.
+  *  The container is designed as binary heap of pointers to items, each item
+  *  holds its own position in the heap, so, insertion and removal take 
+  *  logarithmic time and the most urgent item is always the root.
+  *  Container should always contain at least one item.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(FX_SCHED_ALG)
+
+FX_METADATA(({ implementation: [FX_SCHED_ALG, EDF] }))
+
+//
+// Heap order. Items which are equal by scheduling parameters are ordered by 
+// sequence number assigned when the item is added into the container, so, 
+// equal items are scheduled in FIFO order (it is required for yield and 
+// timeslicing).
+//
+static inline bool
+fx_sched_params_is_before(
+    const fx_sched_params_t* a, 
+    const fx_sched_params_t* b)
+{
+    return fx_sched_params_is_preempt(a, b) || 
+        (fx_sched_params_is_equal(a, b) && 
+            ((int32_t) (a->seq - b->seq)) < 0);
+}
+
+//
+// Finds the heap node by its position in level order (starting from 1). Bits 
+// of the position below the most significant one select the path from the 
+// root: 0 is the left child and 1 is the right one.
+//
+static fx_sched_params_t*
+fx_sched_heap_find(fx_sched_container_t* container, unsigned int pos)
+{
+    fx_sched_params_t* node = container->root;
+    unsigned int bit = 1;
+
+    while (bit <= pos / 2)
+    {
+        bit <<= 1;
+    }
+
+    for (bit >>= 1; bit != 0; bit >>= 1)
+    {
+        node = (pos & bit) ? node->right : node->left;
+    }
+
+    return node;
+}
+
+//
+// Replaces link to the old node in its parent (or the root) by the new node.
+//
+static inline void
+fx_sched_heap_relink(
+    fx_sched_container_t* container, 
+    fx_sched_params_t* parent,
+    fx_sched_params_t* old_node, 
+    fx_sched_params_t* new_node)
+{
+    if (parent == NULL)
+    {
+        container->root = new_node;
+    }
+    else if (parent->left == old_node)
+    {
+        parent->left = new_node;
+    }
+    else
+    {
+        parent->right = new_node;
+    }
+}
+
+//
+// Exchanges the node with its parent.
+//
+static void
+fx_sched_heap_swap(
+    fx_sched_container_t* container, 
+    fx_sched_params_t* parent, 
+    fx_sched_params_t* node)
+{
+    fx_sched_params_t* const left = node->left;
+    fx_sched_params_t* const right = node->right;
+
+    fx_sched_heap_relink(container, parent->parent, parent, node);
+    node->parent = parent->parent;
+
+    if (parent->left == node)
+    {
+        node->left = parent;
+        node->right = parent->right;
+    }
+    else
+    {
+        node->left = parent->left;
+        node->right = parent;
+    }
+
+    if (node->left != parent && node->left != NULL)
+    {
+        node->left->parent = node;
+    }
+
+    if (node->right != parent && node->right != NULL)
+    {
+        node->right->parent = node;
+    }
+
+    parent->parent = node;
+    parent->left = left;
+    parent->right = right;
+
+    if (left != NULL)
+    {
+        left->parent = parent;
+    }
+
+    if (right != NULL)
+    {
+        right->parent = parent;
+    }
+}
+
+//
+// Moves the item toward the root until heap order is restored.
+//
+static void
+fx_sched_heap_up(fx_sched_container_t* container, fx_sched_params_t* item)
+{
+    while (item->parent != NULL && 
+        fx_sched_params_is_before(item, item->parent))
+    {
+        fx_sched_heap_swap(container, item->parent, item);
+    }
+}
+
+//
+// Moves the item toward leaves until heap order is restored.
+//
+static void
+fx_sched_heap_down(fx_sched_container_t* container, fx_sched_params_t* item)
+{
+    for (;;)
+    {
+        fx_sched_params_t* child = item->left;
+
+        if (child == NULL)
+        {
+            break;
+        }
+
+        if (item->right != NULL && 
+            fx_sched_params_is_before(item->right, child))
+        {
+            child = item->right;
+        }
+
+        if (!fx_sched_params_is_before(child, item))
+        {
+            break;
+        }
+
+        fx_sched_heap_swap(container, item, child);
+    }
+}
+
+//!
+//! Constructor of a schedulable item.
+//! @param [in,out] item Target schedulable item to be initialized.
+//! @param [in] type Initialization type, see @ref fx_sched_params_init_t.
+//! @param [in] src  Schedulable item which will be used as source of params in 
+//! case when FX_SCHED_PARAMS_INIT_SPECIFIED specified as the type.
+//! @remark src parameter cannot be NULL if type is 
+//! FX_SCHED_PARAMS_INIT_SPECIFIED.
+//!
+void
+fx_sched_params_init(
+    fx_sched_params_t* item, 
+    fx_sched_params_init_t type, 
+    const fx_sched_params_t* src)
+{
+    switch (type)
+    {
+    case FX_SCHED_PARAMS_INIT_IDLE: 
+        fx_sched_params_init_prio(item, FX_SCHED_ALG_PRIO_IDLE); break;
+    case FX_SCHED_PARAMS_INIT_DEFAULT: 
+        fx_sched_params_init_prio(item, FX_SCHED_ALG_PRIO_IDLE - 1); break;
+    case FX_SCHED_PARAMS_INIT_SPECIFIED: 
+        fx_sched_params_copy(src, item); break;
+    };
+
+    item->container = NULL;
+}
+
+//!
+//! Checks whether the item is unique at its scheduling level, i.e. there are
+//! no other ready items with equal parameters. 
+//! @param [in] item Item to be checked.
+//! @return true if item is unique, false otherwise.
+//! @remark Check is exact for the root of the heap (scheduled item), since
+//! items equal to it can only be its children.
+//!
+bool
+fx_sched_params_is_unique(const fx_sched_params_t* item)
+{
+    if (item->container == NULL)
+    {
+        return true;
+    }
+
+    return !(item->left && fx_sched_params_is_equal(item, item->left)) && 
+        !(item->right && fx_sched_params_is_equal(item, item->right));
+}
+
+//!
+//! Constructor of scheduler container.
+//! @param [in] container Pointer to uninitialized scheduler container.
+//!
+void 
+fx_sched_container_init(fx_sched_container_t* container)
+{
+    container->root = NULL;
+    container->items = 0;
+    container->seq = 0;
+}
+
+//!
+//! Add item to container.
+//! @param [in] container Target scheduler container.
+//! @param [in] item Schedulable item to be added into the container.
+//!
+void 
+fx_sched_container_add(fx_sched_container_t* container, fx_sched_params_t* item)
+{
+    const unsigned int pos = ++container->items;
+
+    item->seq = container->seq++;
+    item->container = container;
+    item->left = item->right = NULL;
+    item->parent = (pos > 1) ? fx_sched_heap_find(container, pos / 2) : NULL;
+
+    if (item->parent == NULL)
+    {
+        container->root = item;
+    }
+    else if (pos & 1)
+    {
+        item->parent->right = item;
+    }
+    else
+    {
+        item->parent->left = item;
+    }
+
+    fx_sched_heap_up(container, item);
+}
+
+//!
+//! Remove item from container.
+//! @param [in] container Target scheduler container.
+//! @param [in] item Schedulable item to be removed from the container.
+//!
+void 
+fx_sched_container_remove(
+    fx_sched_container_t* container, 
+    fx_sched_params_t* item)
+{
+    fx_sched_params_t* const last = fx_sched_heap_find(
+        container, 
+        container->items--
+    );
+
+    item->container = NULL;
+    fx_sched_heap_relink(container, last->parent, last, NULL);
+
+    //
+    // Last item is placed into vacant position and then it is moved up or 
+    // down depending on its relation to the removed item.
+    //
+    if (last != item)
+    {
+        last->parent = item->parent;
+        last->left = item->left;
+        last->right = item->right;
+        fx_sched_heap_relink(container, item->parent, item, last);
+
+        if (last->left != NULL)
+        {
+            last->left->parent = last;
+        }
+
+        if (last->right != NULL)
+        {
+            last->right->parent = last;
+        }
+
+        if (fx_sched_params_is_before(last, item))
+        {
+            fx_sched_heap_up(container, last);
+        }
+        else
+        {
+            fx_sched_heap_down(container, last);
+        }
+    }
+}
+
+//!
+//! Scheduling function.
+//! It selects the most urgent item from items which are contained in the 
+//! specified container.
+//! @param [in] container Container where scheduing should be performed.
+//! @return Scheduled item. 
+//! @warning  Container must contain at least one element before this 
+//! function call.
+//!
+fx_sched_params_t* 
+fx_sched_container_get(fx_sched_container_t* container)
+{
+    return container->root;
+}
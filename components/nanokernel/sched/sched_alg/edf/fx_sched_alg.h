@@ -0,0 +1,177 @@
+#ifndef _FX_SCHED_ALG_EDF_HEADER_
+#define _FX_SCHED_ALG_EDF_HEADER_
+
+/** 
+  ******************************************************************************
+  *  @file   edf/fx_sched_alg.h
+  *  @brief  Interface of earliest-deadline-first scheduler container.
+  *  Items are ordered by priority, items with same priority are ordered by 
+  *  absolute deadline, items without deadline are scheduled after items with 
+  *  deadline. Items with same priority and deadline are scheduled in FIFO 
+  *  order.
+  *  N.B. All container functions expect SPL = SCHED_LEVEL.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(CFG_OPTIONS)
+#include FX_INTERFACE(LANG_TYPES)
+
+#ifndef FX_SCHED_ALG_PRIO_NUM
+#define FX_SCHED_ALG_PRIO_NUM 64
+#endif
+
+struct _fx_sched_container_t;
+
+//!
+//! Scheduler container's item. 
+//! Deadline is absolute time in ticks, deadlines are compared as signed 
+//! difference, so, deadlines of ready items must be within half of the tick 
+//! counter range. Sequence number and heap links are maintained by the 
+//! container and they are not copied with parameters.
+//!
+typedef struct _fx_sched_params_t
+{
+    unsigned int prio;
+    uint32_t deadline;
+    bool timed;
+    uint32_t seq;
+    struct _fx_sched_params_t* parent;
+    struct _fx_sched_params_t* left;
+    struct _fx_sched_params_t* right;
+    struct _fx_sched_container_t* container;
+} 
+fx_sched_params_t;
+
+//! 
+//! Scheduler container representation. 
+//! It is binary min-heap of ready items, the most urgent item is the root.
+//! Heap nodes are linked through the items, so, the container has no capacity 
+//! limit.
+//!
+typedef struct _fx_sched_container_t
+{
+    fx_sched_params_t* root;
+    unsigned int items;
+    uint32_t seq;
+}
+fx_sched_container_t;
+
+//!
+//! Lowest priority has maximum numeric value starting from 0.
+//!
+#define FX_SCHED_ALG_PRIO_IDLE (FX_SCHED_ALG_PRIO_NUM - 1)
+
+//!
+//! Cast scheduling params as integer. 
+//! It is also used for "priority visualization" by external tools.
+//!
+#define fx_sched_params_as_number(s) ((s)->prio)
+
+//!
+//! Checks whether sched params A preempts parameters B.
+//!
+static inline bool
+fx_sched_params_is_preempt(
+    const fx_sched_params_t* a, 
+    const fx_sched_params_t* b)
+{
+    if (a->prio != b->prio)
+    {
+        return a->prio < b->prio;
+    }
+
+    if (a->timed && b->timed)
+    {
+        return ((int32_t) (a->deadline - b->deadline)) < 0;
+    }
+
+    return a->timed && !b->timed;
+}
+
+//!
+//! Check for params equality.
+//!
+#define fx_sched_params_is_equal(a, b) \
+    ((a)->prio == (b)->prio && (a)->timed == (b)->timed && \
+    (!(a)->timed || (a)->deadline == (b)->deadline))
+
+//!
+//! Copy constructor.
+//! @param src Source item from which params will be copied to destination item.
+//! @param dst Destination item.
+//!
+#define fx_sched_params_copy(src, dst) \
+    ((dst)->prio = (src)->prio, (dst)->deadline = (src)->deadline, \
+    (dst)->timed = (src)->timed)
+
+//!
+//! Schedulable item initializer. (priority-specific method).
+//! Deadline is reset, so, initialized item is not timed.
+//! @param [in] item Schedulable item to be initialized.
+//! @param [in] priority Priority which to be set in schedulable item.
+//!
+#define fx_sched_params_init_prio(item, priority) \
+    ((item)->prio = (priority), (item)->deadline = 0, (item)->timed = false)
+
+//!
+//! Deadline accessors. 
+//!
+#define fx_sched_params_set_deadline(item, d) \
+    ((item)->deadline = (d), (item)->timed = true)
+#define fx_sched_params_reset_deadline(item) ((item)->timed = false)
+#define fx_sched_params_has_deadline(item) ((item)->timed)
+#define fx_sched_params_get_deadline(item) ((item)->deadline)
+
+//! 
+//! Default initializers for scheduler container's items. 
+//!
+typedef enum
+{
+    FX_SCHED_PARAMS_INIT_IDLE = 0,  //!< This value is used to init IDLE-entity.
+    FX_SCHED_PARAMS_INIT_DEFAULT,   //!< Default priority.
+    FX_SCHED_PARAMS_INIT_SPECIFIED  //!< Copy sched params from another item.
+}
+fx_sched_params_init_t;
+
+void fx_sched_params_init(
+    fx_sched_params_t* params, 
+    fx_sched_params_init_t type, 
+    const fx_sched_params_t* src
+);
+
+bool fx_sched_params_is_unique(const fx_sched_params_t* params);
+void fx_sched_container_init(fx_sched_container_t* c);
+void fx_sched_container_add(fx_sched_container_t* c, fx_sched_params_t* p);
+void fx_sched_container_remove(fx_sched_container_t* c, fx_sched_params_t* p);
+fx_sched_params_t* fx_sched_container_get(fx_sched_container_t* c);
+
+FX_METADATA(({ interface: [FX_SCHED_ALG, EDF] }))
+
+FX_METADATA(({ options: [
+    FX_SCHED_ALG_PRIO_NUM: {
+        type: int, range: [8, 1024], default: 64,
+        description: "Number of scheduling priorities."}]}))
+
+#endif
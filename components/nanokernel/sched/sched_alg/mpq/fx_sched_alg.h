@@ -106,6 +106,15 @@ fx_sched_params_t;
 //!
 #define fx_sched_params_init_prio(item, priority) ((item)->prio = (priority))
 
+//!
+//! Deadline accessors. Deadlines are not supported by the container, so, 
+//! setting is ignored and items never have deadline.
+//!
+#define fx_sched_params_set_deadline(item, d) ((void) (item), (void) (d))
+#define fx_sched_params_reset_deadline(item) ((void) (item))
+#define fx_sched_params_has_deadline(item) ((void) (item), false)
+#define fx_sched_params_get_deadline(item) ((void) (item), UINT32_C(0))
+
 //! 
 //! Default initializers for scheduler container's items. 
 //!
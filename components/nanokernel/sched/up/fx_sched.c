@@ -49,9 +49,13 @@ lang_static_assert(HAL_MP_CPU_MAX == 1);
 typedef struct
 {
     bool resched_pending;           //!< If the flag is set: resched is pending.
+    bool active_ready;              //!< Active item is ready and not yielded.
     unsigned int changes_counter;   //!< Counts changes of scheduling state.
+    unsigned int handoff_stamp;     //!< Changes counter at handoff request.
     fx_sched_container_t g_domain;  //!< Container of executable entities.
     fx_sched_item_t* active;        //!< Currently active item.
+    fx_sched_item_t* handoff;       //!< Item preempting the active one.
+    fx_sched_item_t* preempted;     //!< Preempted threshold owners stack.
 }
 fx_sched_context_t;
 
@@ -69,6 +73,60 @@ fx_sched_ctor(void)
     fx_sched_container_init(&(context->g_domain));
 }
 
+//
+// Threshold is a priority, so, it is compared by priority only (params may 
+// contain other attributes, like deadline, which do not affect the threshold).
+//
+#define fx_sched_prio_is_higher(a, b) \
+    (fx_sched_params_as_number(a) < fx_sched_params_as_number(b))
+
+#define fx_sched_threshold_is_set(item) \
+    fx_sched_prio_is_higher(&(item)->threshold, &(item)->sched_params)
+
+//
+// Preemption threshold of the item takes effect only if it is higher than 
+// item's own priority, it is active while the item is running and also while
+// the item is preempted by more urgent items (until it runs again or leaves 
+// the container). Preempted items with thresholds form a stack, the most 
+// recently preempted one has the highest threshold, since the item preempting
+// it exceeded its threshold. So, the threshold guarding the CPU belongs to the
+// active item if it is ready or to the top of preempted items stack.
+//
+static bool
+fx_sched_is_preemptible(
+    const fx_sched_context_t* context, 
+    const fx_sched_params_t* params)
+{
+    const fx_sched_item_t* const guard = 
+        context->active_ready ? context->active : context->preempted;
+
+    return guard == NULL || 
+        !fx_sched_threshold_is_set(guard) ||
+        fx_sched_prio_is_higher(params, &guard->threshold);
+}
+
+//
+// Removes item from the stack of preempted items (if it is there). 
+// Stack depth is limited by the number of distinct thresholds, so, linear 
+// search is used.
+//
+static void
+fx_sched_preempted_remove(fx_sched_context_t* context, fx_sched_item_t* item)
+{
+    fx_sched_item_t** link = &context->preempted;
+
+    while (*link != NULL && *link != item)
+    {
+        link = &((*link)->preempted);
+    }
+
+    if (*link != NULL)
+    {
+        *link = item->preempted;
+        item->preempted = NULL;
+    }
+}
+
 //!
 //! Rescheduling request.
 //!
@@ -108,6 +166,12 @@ fx_sched_item_init(
 {
     fx_sched_params_init( fx_sched_item_as_sched_params(item), t, arg);
 
+    //
+    // Threshold is lowest by default, so, it does not restrict preemption.
+    //
+    fx_sched_params_init(&item->threshold, FX_SCHED_PARAMS_INIT_IDLE, NULL);
+    item->preempted = NULL;
+
     //
     // Initialized items always suspended.
     //
@@ -142,11 +206,13 @@ fx_sched_item_remove(fx_sched_item_t* item)
             &context->g_domain, 
             fx_sched_item_as_sched_params(item)
         );
+        fx_sched_preempted_remove(context, item);
 
         ++context->changes_counter;
 
         if (context->active == item)
         {
+            context->active_ready = false;
             fx_sched_mark_resched_needed();
         }
     }
@@ -179,9 +245,13 @@ fx_sched_item_set_params(fx_sched_item_t* item, const fx_sched_params_t* src)
         static fx_sched_params_t saved_params = { 0 };
         static unsigned int timestamp = 0;
 
+        //
+        // Changes counter is advanced on every change, so, handoff target 
+        // selected before the change is not used by the dispatcher.
+        //
         if (self && raising_prio)
         {
-            timestamp = context->changes_counter;
+            timestamp = ++context->changes_counter;
             fx_sched_params_copy(
                 fx_sched_item_as_sched_params(item), 
                 &saved_params
@@ -216,6 +286,44 @@ fx_sched_item_set_params(fx_sched_item_t* item, const fx_sched_params_t* src)
     }
 }
 
+//!
+//! Setting preemption threshold for schedulable entity. While the entity is 
+//! active it may be preempted only by entities which preempt the threshold.
+//! Threshold which does not preempt entity's own params has no effect.
+//! @param [in] item Scheduling entity in which threshold should be changed.
+//! @param [in] src Threshold to be copied into target.
+//! @sa fx_sched_item_get_threshold
+//!
+void
+fx_sched_item_set_threshold(
+    fx_sched_item_t* item, 
+    const fx_sched_params_t* src)
+{
+    fx_sched_context_t* context = fx_sched_get_context();
+    fx_sched_params_copy(src, &item->threshold);
+
+    //
+    // Lowering the threshold of the active (or preempted) item may allow some 
+    // of ready items to preempt it.
+    //
+    if (item == context->active || context->preempted != NULL)
+    {
+        ++context->changes_counter;
+        fx_sched_mark_resched_needed();
+    }
+}
+
+//!
+//! Returns preemption threshold of schedulable entity.
+//! @param [in] src Source of the threshold.
+//! @param [in,out] dst Placeholder of threshold extracted from source item.
+//!
+void 
+fx_sched_item_get_threshold(fx_sched_item_t* src, fx_sched_params_t* dst)
+{
+    fx_sched_params_copy(&src->threshold, dst);
+}
+
 //!
 //! Returns scheduling parameters of schedulable entity.
 //! @param [in] src Source of scheduling params.
@@ -251,7 +359,14 @@ fx_sched_item_suspend(fx_sched_item_t* item)
             &context->g_domain, 
             fx_sched_item_as_sched_params(item)
         );
+        fx_sched_preempted_remove(context, item);
         ++context->changes_counter;
+
+        if (context->active == item)
+        {
+            context->active_ready = false;
+        }
+
         fx_sched_mark_resched_needed();
     }
 
@@ -276,6 +391,7 @@ fx_sched_item_resume(fx_sched_item_t* item)
     if (prev_suspend_count > 0 && --(item->suspend_count) == 0)
     {
         fx_sched_context_t* context = fx_sched_get_context();
+        const bool settled = context->active_ready && !context->resched_pending;
         fx_sched_container_add(
             &context->g_domain, 
             fx_sched_item_as_sched_params(item)
@@ -283,13 +399,37 @@ fx_sched_item_resume(fx_sched_item_t* item)
 
         ++context->changes_counter;
 
-        if (fx_sched_params_is_equal(
+        //
+        // Items which do not exceed preemption threshold of the active (or 
+        // preempted) item remain in the container until the threshold owner 
+        // is suspended.
+        //
+        if (fx_sched_is_preemptible(
+                context, 
+                fx_sched_item_as_sched_params(item)) &&
+            (fx_sched_params_is_equal(
                 fx_sched_item_as_sched_params(item),
                 fx_sched_item_as_sched_params(context->active)) ||
             fx_sched_params_is_preempt(
                 fx_sched_item_as_sched_params(item), 
-                fx_sched_item_as_sched_params(context->active)))
+                fx_sched_item_as_sched_params(context->active))))
         {
+            //
+            // If the active item was selected by the scheduler and nothing 
+            // changed since that, resumed item preempting it is the next one
+            // to run (items held by the threshold do not exceed it), so, it 
+            // may be handed the CPU without container lookup. Handoff is 
+            // discarded if scheduling state changes once again before 
+            // dispatch.
+            //
+            if (settled && fx_sched_params_is_preempt(
+                    fx_sched_item_as_sched_params(item), 
+                    fx_sched_item_as_sched_params(context->active)))
+            {
+                context->handoff = item;
+                context->handoff_stamp = context->changes_counter;
+            }
+
             fx_sched_mark_resched_needed();
         }
     }
@@ -310,10 +450,50 @@ fx_sched_get_next(void)
 
     if (context->resched_pending == 1)
     {
-        fx_sched_params_t* item = fx_sched_container_get(&context->g_domain);
-        next = lang_containing_record(item, fx_sched_item_t, sched_params);
+        fx_sched_item_t* const active = context->active;
+
+        if (context->handoff != NULL && 
+            context->handoff_stamp == context->changes_counter)
+        {
+            next = context->handoff;
+        }
+        else
+        {
+            fx_sched_params_t* item = fx_sched_container_get(
+                &context->g_domain
+            );
+
+            //
+            // If the most urgent item does not exceed preemption threshold of
+            // the active item (if it is still ready) or of the last preempted 
+            // item, the threshold owner runs.
+            //
+            if (!fx_sched_is_preemptible(context, item))
+            {
+                item = context->active_ready ? 
+                    fx_sched_item_as_sched_params(active) : 
+                    fx_sched_item_as_sched_params(context->preempted);
+            }
+
+            next = lang_containing_record(item, fx_sched_item_t, sched_params);
+        }
+
+        //
+        // Ready item with threshold being preempted keeps its threshold until
+        // it runs again.
+        //
+        if (context->active_ready && next != active && 
+            fx_sched_threshold_is_set(active))
+        {
+            active->preempted = context->preempted;
+            context->preempted = active;
+        }
+
+        fx_sched_preempted_remove(context, next);
+        context->handoff = NULL;
         context->resched_pending = false; 
         context->active = next;
+        context->active_ready = true;
     }
 
     return next;
@@ -321,6 +501,8 @@ fx_sched_get_next(void)
 
 //!
 //! Placing specified item at end of queue.
+//! Yielding item gives up the processor regardless of its preemption 
+//! threshold.
 //!
 bool
 fx_sched_yield(fx_sched_item_t* item)
@@ -340,6 +522,12 @@ fx_sched_yield(fx_sched_item_t* item)
         );
         result = true;
         ++context->changes_counter;
+
+        if (context->active == item)
+        {
+            context->active_ready = false;
+        }
+
         fx_sched_mark_resched_needed();
     }
     return result;
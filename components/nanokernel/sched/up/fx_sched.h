@@ -39,10 +39,12 @@
 //!
 //! Schedulable entity.
 //!
-typedef struct
+typedef struct _fx_sched_item_t
 {
     unsigned int suspend_count;     //!< Item suspended if this value is > 0.
     fx_sched_params_t sched_params; //!< Associated parameters, priority, etc.
+    fx_sched_params_t threshold;    //!< Preemption threshold.
+    struct _fx_sched_item_t* preempted; //!< Next preempted threshold owner.
 }
 fx_sched_item_t;
 
@@ -59,6 +61,11 @@ void fx_sched_item_init(
 void fx_sched_item_remove(fx_sched_item_t* item);
 void fx_sched_item_get_params(fx_sched_item_t* src, fx_sched_params_t* dst);
 void fx_sched_item_set_params(fx_sched_item_t* dst, const fx_sched_params_t* s);
+void fx_sched_item_get_threshold(fx_sched_item_t* src, fx_sched_params_t* dst);
+void fx_sched_item_set_threshold(
+    fx_sched_item_t* dst, 
+    const fx_sched_params_t* s
+);
 unsigned int fx_sched_item_suspend(fx_sched_item_t* item);
 unsigned int fx_sched_item_resume(fx_sched_item_t* item);
 bool fx_sched_yield(fx_sched_item_t* item);
@@ -41,8 +41,17 @@
   
 typedef struct { int dummy; } fx_dpc_t;
 
+typedef enum
+{
+    FX_DPC_IMPORTANCE_HIGH = 0,
+    FX_DPC_IMPORTANCE_LOW,
+    FX_DPC_IMPORTANCE_MAX
+}
+fx_dpc_importance_t;
+
 #define fx_dpc_ctor()
 #define fx_dpc_init(dpc)
+#define fx_dpc_set_importance(dpc, importance)
 #define fx_dpc_request(dpc, func, arg) (func(dpc, arg), true)
 #define fx_dpc_cancel(dpc) (false)
 #define fx_dpc_set_target_cpu(dpc, cpu) fx_dbg_assert(cpu == 0)
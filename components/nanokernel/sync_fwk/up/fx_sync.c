@@ -52,9 +52,106 @@ fx_sync_waitable_init(
     bool (*test_func)(fx_sync_waitable_t*, fx_sync_wait_block_t*, const bool))
 {
     rtl_queue_init(&w->wq);
+#if defined FX_SYNC_PRIO_QUEUE
+    rtl_queue_init(&w->pq);
+    rtl_queue_init(&w->groups);
+#endif
     w->test_wait = test_func;
 }
 
+#if defined FX_SYNC_PRIO_QUEUE
+
+//
+// Inserts wait block into the priority queue after all wait blocks with the
+// same or higher priority. Only group heads are checked, so, insertion time
+// depends on the number of distinct priorities rather than number of waiters.
+// @warning This function assumes object is already locked by caller.
+//
+static void
+_fx_sync_prio_insert(fx_sync_waitable_t* waitable, fx_sync_wait_block_t* wb)
+{
+    const fx_sched_params_t* const params = wb->waiter->sched_params;
+    rtl_queue_t* const groups = &waitable->groups;
+    rtl_queue_t* n = NULL;
+
+    for (n = rtl_queue_first(groups); n != groups; n = rtl_queue_next(n))
+    {
+        fx_sync_wait_block_t* const head = rtl_queue_entry(
+            n, 
+            fx_sync_wait_block_t, 
+            group_link
+        );
+
+        if (fx_sched_params_is_preempt(params, head->waiter->sched_params))
+        {
+            //
+            // New priority group is inserted before the current one.
+            //
+            rtl_enqueue(&head->prio_link, &wb->prio_link);
+            rtl_enqueue(n, &wb->group_link);
+            return;
+        }
+
+        if (fx_sched_params_is_equal(params, head->waiter->sched_params))
+        {
+            //
+            // Wait block is appended to the tail of existing group, which ends
+            // before the head of the next group.
+            //
+            rtl_queue_t* const next = rtl_queue_next(n);
+            rtl_queue_t* const tail = (next == groups) ? 
+                &waitable->pq : 
+                &(rtl_queue_entry(next, fx_sync_wait_block_t, group_link)->
+                    prio_link);
+
+            rtl_enqueue(tail, &wb->prio_link);
+            rtl_queue_item_init(&wb->group_link);
+            return;
+        }
+    }
+
+    rtl_enqueue(&waitable->pq, &wb->prio_link);
+    rtl_enqueue(groups, &wb->group_link);
+}
+
+//
+// Removes wait block from the priority queue. If the block is the head of 
+// priority group, the next block in the group becomes the head. Since it is 
+// determined by links only, it works even if waiter's priority is changed.
+// @warning This function assumes object is already locked by caller.
+//
+static void
+_fx_sync_prio_remove(fx_sync_waitable_t* waitable, fx_sync_wait_block_t* wb)
+{
+    if (rtl_queue_is_item_linked(&wb->group_link))
+    {
+        rtl_queue_t* const next = rtl_queue_next(&wb->prio_link);
+
+        if (next != &waitable->pq)
+        {
+            fx_sync_wait_block_t* const next_wb = rtl_queue_entry(
+                next, 
+                fx_sync_wait_block_t, 
+                prio_link
+            );
+
+            if (!rtl_queue_is_item_linked(&next_wb->group_link))
+            {
+                rtl_queue_insert(&wb->group_link, &next_wb->group_link);
+            }
+        }
+
+        rtl_queue_remove(&wb->group_link);
+    }
+
+    rtl_queue_remove(&wb->prio_link);
+}
+
+#else
+#define _fx_sync_prio_insert(waitable, wb)
+#define _fx_sync_prio_remove(waitable, wb)
+#endif
+
 //!
 //! Start of wait operation. Creates a link between waitable object and waiter.
 //! @warning This function assumes object is already locked by caller.
@@ -64,6 +161,26 @@ _fx_sync_wait_start(fx_sync_waitable_t* waitable, fx_sync_wait_block_t* wb)
 {
     wb->waitable = waitable; 
     rtl_enqueue(&waitable->wq, &wb->link);
+    _fx_sync_prio_insert(waitable, wb);
+}
+
+//!
+//! Moves wait block from one waitable to another. The waiter remains blocked
+//! and it will be notified by the target waitable.
+//! @param [in] from Waitable containing the wait block.
+//! @param [in] to Target waitable.
+//! @param [in,out] wb Wait block to be moved.
+//! @warning This function assumes both objects are locked by caller.
+//!
+void
+_fx_sync_wait_requeue(
+    fx_sync_waitable_t* from, 
+    fx_sync_waitable_t* to, 
+    fx_sync_wait_block_t* wb)
+{
+    rtl_queue_remove(&wb->link);
+    _fx_sync_prio_remove(from, wb);
+    _fx_sync_wait_start(to, wb);
 }
 
 //!
@@ -72,6 +189,8 @@ _fx_sync_wait_start(fx_sync_waitable_t* waitable, fx_sync_wait_block_t* wb)
 //! @param [in] policy Queue scheduling policy.
 //! @return Wait block of waiter to be unlocked according to policy or NULL.
 //! @warning  This function assumes object is already locked by caller.
+//! @remark PRIO policy takes constant time if priority queue is enabled, 
+//! otherwise all waiters are scanned.
 //!
 fx_sync_wait_block_t*   
 _fx_sync_wait_block_get(fx_sync_waitable_t* waitable, fx_sync_policy_t policy)
@@ -84,6 +203,13 @@ _fx_sync_wait_block_get(fx_sync_waitable_t* waitable, fx_sync_policy_t policy)
 
     if (policy == FX_SYNC_POLICY_PRIO)
     {
+#if defined FX_SYNC_PRIO_QUEUE
+        next = rtl_queue_entry(
+            rtl_queue_first(&waitable->pq), 
+            fx_sync_wait_block_t, 
+            prio_link
+        );
+#else
         rtl_queue_t* head = &waitable->wq;
         rtl_queue_t* n = NULL;
 
@@ -99,13 +225,38 @@ _fx_sync_wait_block_get(fx_sync_waitable_t* waitable, fx_sync_policy_t policy)
                 next = wb;
             }
         }
+#endif
     }
 
     return next;
 }
 
+//
+// Cancels all wait blocks of the waiter which are still linked to waitables.
+// @warning This function assumes waiter's objects are locked by caller.
+//
+static void
+_fx_sync_waiter_cancel_blocks(fx_sync_waiter_t* waiter)
+{
+    unsigned int i = 0;
+
+    for (i = 0; i < waiter->wb_num; ++i)
+    {
+        fx_sync_wait_block_t* wb = &(waiter->wb[i]);       
+        if (wb->waitable)
+        {
+            rtl_queue_remove(&wb->link);
+            _fx_sync_prio_remove(wb->waitable, wb);
+            wb->u.status = FX_WAIT_CANCELLED;
+            wb->waitable = NULL;
+        }
+    }
+}
+
 //!
-//! Notification by wait block
+//! Notification by wait block. Waiter is notified when the wait is satisfied,
+//! at this moment all its remaining wait blocks are cancelled, so, objects
+//! waited by OR cannot be consumed by the waiter more than once.
 //! @param [in] waitable Target waitable.
 //! @param [in] reason Notifocation reason which must be provided by hi-level.
 //! @param [in] wb Wait block of waiter to be released. 
@@ -117,9 +268,19 @@ _fx_sync_wait_notify_one(
     fx_wait_status_t reason, 
     fx_sync_wait_block_t* wb)
 {
+    fx_sync_waiter_t* const waiter = wb->waiter;
+    const unsigned int index = (unsigned int) (wb - waiter->wb);
+
     wb->u.status = reason;
     wb->waitable = NULL;
-    fx_sync_waiter_notify(wb->waiter); 
+
+    if (reason != FX_WAIT_SATISFIED || 
+        index >= waiter->expected || 
+        --waiter->remaining == 0)
+    {
+        _fx_sync_waiter_cancel_blocks(waiter);
+        fx_sync_waiter_notify(waiter); 
+    }
 }
 
 //!
@@ -140,6 +301,7 @@ _fx_sync_wait_notify(
     if (wb)
     {
         rtl_queue_remove(&wb->link);
+        _fx_sync_prio_remove(waitable, wb);
         _fx_sync_wait_notify_one(waitable, reason, wb);
     }
     else
@@ -148,6 +310,7 @@ _fx_sync_wait_notify(
         while ((q = rtl_dequeue(&waitable->wq)) != NULL)
         {
             fx_sync_wait_block_t* wb_to_notify = fx_sync_queue_item_as_wb(q);
+            _fx_sync_prio_remove(waitable, wb_to_notify);
             _fx_sync_wait_notify_one(waitable, reason, wb_to_notify); 
         }
     }
@@ -161,19 +324,35 @@ unsigned int
 fx_sync_wait_rollback(fx_sync_waiter_t* waiter)
 {
     const unsigned int wb_num = waiter->wb_num;
-    unsigned int i = 0;
+    _fx_sync_waiter_cancel_blocks(waiter);
     waiter->wb_num = 0;
+    return wb_num;
+}
+
+#if defined FX_SYNC_PRIO_QUEUE
+
+//!
+//! Updates position of waiter's wait blocks in priority queues. It should be 
+//! called when scheduling parameters of the blocked waiter are changed. 
+//! Wait blocks are moved to the tail of the new priority group.
+//! @param [in,out] waiter Waiter, whose scheduling parameters are changed.
+//! @warning This function assumes waiter's objects are locked by caller.
+//!
+void
+fx_sync_waiter_params_changed(fx_sync_waiter_t* waiter)
+{
+    unsigned int i = 0;
 
-    for (i = 0; i < wb_num; ++i)
+    for (i = 0; i < waiter->wb_num; ++i)
     {
-        fx_sync_wait_block_t* wb = &(waiter->wb[i]);       
+        fx_sync_wait_block_t* const wb = &(waiter->wb[i]);
+
         if (wb->waitable)
         {
-            rtl_queue_remove(&wb->link);
-            wb->u.status = FX_WAIT_CANCELLED;
-            wb->waitable = NULL;
+            _fx_sync_prio_remove(wb->waitable, wb);
+            _fx_sync_prio_insert(wb->waitable, wb);
         }
     }
-
-    return wb_num;
 }
+
+#endif
@@ -30,6 +30,7 @@
   *  POSSIBILITY OF SUCH DAMAGE.
   *****************************************************************************/
 
+#include FX_INTERFACE(CFG_OPTIONS)
 #include FX_INTERFACE(LANG_TYPES)
 #include FX_INTERFACE(RTL_QUEUE)
 #include FX_INTERFACE(FX_SCHED_ALG)
@@ -73,10 +74,22 @@ fx_wait_status_t;
 //! It is base class for all synchronization primitives and contains queue of
 //! wait objects. The test function atomically tests the object and inserts 
 //! block to the queue if the object is in nonsignaled state.
+//! If FX_SYNC_PRIO_QUEUE is set, wait blocks are also linked into 
+//! priority-sorted queue (FIFO order within same priority). First wait block 
+//! of each priority is also linked into the group queue, so, insertion takes 
+//! time proportional to the number of distinct priorities of waiters and the 
+//! most prioritized waiter is always the first item in the priority queue 
+//! (with deadline scheduling waiters rarely have equal parameters, so, 
+//! insertion becomes linear). Otherwise, the FIFO queue is scanned in order 
+//! to find the most prioritized waiter.
 //!
 struct _fx_sync_waitable_t
 {
     rtl_queue_t wq;          
+#if defined FX_SYNC_PRIO_QUEUE
+    rtl_queue_t pq;
+    rtl_queue_t groups;
+#endif
     bool (*test_wait)(fx_sync_waitable_t*, fx_sync_wait_block_t*, const bool);
 };
 
@@ -85,12 +98,19 @@ struct _fx_sync_waitable_t
 //! N.B. Waiter methods is NOT thread safe. It is expected that waiter is a
 //! thread and therefore all waiter methods are called in context of one 
 //! thread (sequentially).
+//! Expected value is the number of wait blocks at the beginning of the array 
+//! which must be notified in order to satisfy the wait (1 means wait by OR).
+//! Notification of any wait block beyond expected ones (i.e. cancel event) 
+//! satisfies the wait immediately. Remaining blocks are cancelled when the
+//! wait is satisfied.
 //!
 struct _fx_sync_waiter_t
 {
     fx_sched_params_t* sched_params;
     fx_sync_wait_block_t* wb;
     unsigned int wb_num;
+    unsigned int expected;
+    unsigned int remaining;
 };
 
 //!
@@ -115,6 +135,10 @@ struct _fx_sync_wait_block_t
         fx_wait_status_t status;
     } u;                                        
     rtl_queue_linkage_t link;
+#if defined FX_SYNC_PRIO_QUEUE
+    rtl_queue_linkage_t prio_link;
+    rtl_queue_linkage_t group_link;
+#endif
 };
 
 #define fx_sync_waitable_lock(w)
@@ -128,13 +152,24 @@ struct _fx_sync_wait_block_t
     (rtl_queue_entry(item, fx_sync_wait_block_t, link))
 #define fx_sync_wait_block_get_status(wb) ((wb)->u.status)
 #define fx_sync_wait_block_get_attr(wb) ((wb)->u.attribute)
+#if defined FX_SYNC_PRIO_QUEUE
+#define FX_SYNC_WAIT_BLOCK_INITIALIZER(wtr, wtbl, attr) \
+    {(wtr), NULL, {attr}, RTL_QUEUE_INITIALIZER, RTL_QUEUE_INITIALIZER, \
+    RTL_QUEUE_INITIALIZER}
+#else
 #define FX_SYNC_WAIT_BLOCK_INITIALIZER(wtr, wtbl, attr) \
     {(wtr), NULL, {attr}, RTL_QUEUE_INITIALIZER}
+#endif
 
 //!
 //! Preparing waiter for new wait operation. Should be perfermed before every 
-//! wait operation. This implementation supports only waits by OR, so, expected 
-//! notification number is always 1 and therefore unused.
+//! wait operation. 
+//! @param [in,out] waiter Waiter to be prepared.
+//! @param [in] wb_array Array of wait blocks.
+//! @param [in] wb_n Number of wait blocks in the array.
+//! @param [in] expected Number of notifications required to satisfy the wait.
+//! 1 means wait by OR, otherwise first "expected" wait blocks are waited by 
+//! AND.
 //!
 static inline void 
 fx_sync_waiter_prepare(
@@ -145,6 +180,22 @@ fx_sync_waiter_prepare(
 {
     waiter->wb = wb_array;
     waiter->wb_num = wb_n;
+    waiter->expected = expected;
+    waiter->remaining = expected;
+}
+
+//!
+//! Accounts wait block which is satisfied synchronously by test function 
+//! (without being inserted into the queue).
+//! @param [in,out] waiter Waiter which is prepared for wait.
+//! @param [in,out] wb Wait block satisfied by test function.
+//! @return true if the wait is satisfied (no more notifications expected).
+//!
+static inline bool
+fx_sync_waiter_satisfy(fx_sync_waiter_t* waiter, fx_sync_wait_block_t* wb)
+{
+    wb->u.status = FX_WAIT_SATISFIED;
+    return --waiter->remaining == 0;
 }
 
 void fx_sync_waitable_init(
@@ -165,9 +216,25 @@ void _fx_sync_wait_notify(
 );
 
 void _fx_sync_wait_start(fx_sync_waitable_t* w, fx_sync_wait_block_t* wb);
+void _fx_sync_wait_requeue(
+    fx_sync_waitable_t* from, 
+    fx_sync_waitable_t* to, 
+    fx_sync_wait_block_t* wb
+);
 unsigned int fx_sync_wait_rollback(fx_sync_waiter_t* waiter);
 extern void fx_sync_waiter_notify(fx_sync_waiter_t* waiter);
 
+#if defined FX_SYNC_PRIO_QUEUE
+void fx_sync_waiter_params_changed(fx_sync_waiter_t* waiter);
+#else
+#define fx_sync_waiter_params_changed(waiter) ((void) (waiter))
+#endif
+
 FX_METADATA(({ interface: [FX_SYNC, UP_QUEUE] }))
 
+FX_METADATA(({ options: [
+    FX_SYNC_PRIO_QUEUE: {
+        type: int, range: [0, 1], default: 0,
+        description: "Keep wait queues sorted by priority of waiters."}]}))
+
 #endif
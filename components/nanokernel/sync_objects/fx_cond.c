@@ -33,6 +33,18 @@ FX_METADATA(({ implementation: [FX_COND, V1] }))
 
 #define fx_cond_is_valid(cond) (fx_rtp_check((&((cond)->rtp)), FX_COND_MAGIC))
 
+//
+// Wait attributes. Requeued flag is set by signaling thread when the waiter 
+// is moved into the mutex queue instead of being woken up, in this case the 
+// condvar wait is satisfied regardless of the status returned by the wait.
+//
+typedef struct
+{
+    fx_mutex_t* mutex;
+    bool requeued;
+}
+fx_cond_wait_attr_t;
+
 //!
 //! Test and wait function. It is used for wait implementation.
 //! @param [in] object Condvar object to be tested.
@@ -48,7 +60,8 @@ fx_cond_test_and_wait(
     fx_sync_wait_block_t* wb, 
     const bool wait)
 {
-    fx_mutex_t* mutex = fx_sync_wait_block_get_attr(wb);
+    fx_cond_wait_attr_t* const attr = fx_sync_wait_block_get_attr(wb);
+    fx_mutex_t* const mutex = attr->mutex;
 
     // 
     // Condvar is always causes thread to wait, until explicitly signaled by 
@@ -65,6 +78,55 @@ fx_cond_test_and_wait(
     return false;
 }
 
+//
+// Releases the waiter. If the mutex associated with the wait is owned by 
+// another thread, the waiter is moved into the mutex queue (wait morphing), 
+// so, it remains blocked until the mutex is passed to it. Otherwise the waiter
+// is woken up and it acquires the mutex by itself.
+// Note: mutex is locked while the condvar is locked, mutex functions never 
+// lock condvars, so, this nesting is safe.
+// @warning This function assumes the condvar is locked by caller.
+// @remark SPL = SCHED_LEVEL
+//
+static void
+fx_cond_release_waiter(fx_cond_t* cond, fx_sync_wait_block_t* wb)
+{
+    fx_cond_wait_attr_t* const attr = fx_sync_wait_block_get_attr(wb);
+
+    if (fx_mutex_requeue(attr->mutex, &cond->waitable, wb))
+    {
+        attr->requeued = true;
+    }
+    else
+    {
+        _fx_sync_wait_notify(&cond->waitable, FX_WAIT_SATISFIED, wb);
+    }
+}
+
+//
+// Completes the wait. The mutex must be re-acquired before return, if the 
+// waiter has been moved into the mutex queue it may already own the mutex.
+//
+static int
+fx_cond_wait_complete(fx_cond_wait_attr_t* attr, int cond_wait_res)
+{
+    int mutex_wait_res = FX_MUTEX_OK;
+
+    if (attr->requeued)
+    {
+        cond_wait_res = FX_COND_OK;
+        mutex_wait_res = fx_mutex_requeue_complete(attr->mutex);
+    }
+    else
+    {
+        mutex_wait_res = fx_mutex_acquire(attr->mutex, NULL);
+    }
+
+    return (mutex_wait_res == FX_MUTEX_OK) ? 
+        cond_wait_res : 
+        FX_COND_MUTEX_ERROR;
+}
+
 //!
 //! Initializes a condvar.
 //! @param [in,out] cond Condvar object to be initialized.
@@ -112,7 +174,8 @@ fx_cond_deinit(fx_cond_t* cond)
 //!
 //! Signaling of a condvar.
 //! It releases one waiting thread in accordance with queue policy 
-//! (FIFO or priority-based).
+//! (FIFO or priority-based). If associated mutex is held (i.e. by the caller)
+//! the thread is moved into the mutex queue and resumed when it gets the mutex.
 //! @param [in,out] cond Condvar object to be signaled.
 //! @param [in] policy Notification policy (FIFO or priority-based).
 //! @return FX_COND_OK in case of success, error code otherwise.
@@ -135,7 +198,7 @@ fx_cond_signal_with_policy(fx_cond_t* cond, const fx_sync_policy_t policy)
             &cond->waitable, 
             policy
         );
-        _fx_sync_wait_notify(&cond->waitable, FX_WAIT_SATISFIED, wb);
+        fx_cond_release_waiter(cond, wb);
         error = FX_COND_OK;
     }
     fx_sync_waitable_unlock(&cond->waitable);
@@ -165,6 +228,8 @@ fx_cond_signal(fx_cond_t* cond)
 //! Broadcast signaling of a condvar.
 //! Releasing all threads, who starts the wait before this function has called.
 //! Threads who blocks after (including this moment) will not be released.
+//! If associated mutex is held, waiters are moved into the mutex queue rather 
+//! than woken up, so, they are resumed one by one as the mutex is released.
 //! @param [in,out] cond Condvar object to be signaled.
 //! @return FX_COND_OK in case of success, error code otherwise.
 //! @sa fx_cond_signal
@@ -178,7 +243,16 @@ fx_cond_broadcast(fx_cond_t* cond)
 
     fx_sched_lock(&prev);
     fx_sync_waitable_lock(&cond->waitable);
-    _fx_sync_wait_notify(&cond->waitable, FX_WAIT_SATISFIED, NULL);
+
+    while (_fx_sync_waitable_nonempty(&cond->waitable))
+    {
+        fx_sync_wait_block_t* wb = _fx_sync_wait_block_get(
+            &cond->waitable, 
+            FX_SYNC_POLICY_FIFO
+        );
+        fx_cond_release_waiter(cond, wb);
+    }
+
     fx_sync_waitable_unlock(&cond->waitable);
     fx_sched_unlock(prev);
     return FX_COND_OK;
@@ -199,6 +273,7 @@ fx_cond_broadcast(fx_cond_t* cond)
 int  
 fx_cond_wait(fx_cond_t* cond, fx_mutex_t* mutex, fx_event_t* cancel_event)
 {
+    fx_cond_wait_attr_t attr;
     lang_param_assert(cond != NULL, FX_COND_INVALID_PTR);
     lang_param_assert(fx_cond_is_valid(cond), FX_COND_INVALID_OBJ);  
     lang_param_assert(mutex != NULL, FX_COND_INVALID_MUTEX);
@@ -211,20 +286,19 @@ fx_cond_wait(fx_cond_t* cond, fx_mutex_t* mutex, fx_event_t* cancel_event)
         // Wait for condition variable. It will cause "test_and_wait" virtual 
         // method to be called, which releases the mutex.
         //
-        const int cond_wait_res = fx_thread_wait_object(
+        int cond_wait_res = FX_COND_OK;
+        attr.mutex = mutex;
+        attr.requeued = false;
+        cond_wait_res = fx_thread_wait_object(
             &cond->waitable, 
-            mutex, 
+            &attr, 
             cancel_event
         );
 
         //
         // Before return from cond_wait function the mutex must be re-acquired.
         //
-        const int mutex_wait_res = fx_mutex_acquire(mutex, NULL);
-
-        return (mutex_wait_res == FX_MUTEX_OK) ? 
-            cond_wait_res : 
-            FX_COND_MUTEX_ERROR;
+        return fx_cond_wait_complete(&attr, cond_wait_res);
     }
 }
 
@@ -243,6 +317,7 @@ fx_cond_wait(fx_cond_t* cond, fx_mutex_t* mutex, fx_event_t* cancel_event)
 int  
 fx_cond_timedwait(fx_cond_t* cond, fx_mutex_t* mutex, uint32_t tout)
 {
+    fx_cond_wait_attr_t attr;
     lang_param_assert(cond != NULL, FX_COND_INVALID_PTR);
     lang_param_assert(fx_cond_is_valid(cond), FX_COND_INVALID_OBJ);  
     lang_param_assert(mutex != NULL, FX_COND_INVALID_MUTEX);
@@ -256,19 +331,18 @@ fx_cond_timedwait(fx_cond_t* cond, fx_mutex_t* mutex, uint32_t tout)
         // Wait for condition variable. It will cause "test_and_wait" virtual 
         // method to be called, which releases the mutex.
         //
-        const int cond_wait_res = fx_thread_timedwait_object(
+        int cond_wait_res = FX_COND_OK;
+        attr.mutex = mutex;
+        attr.requeued = false;
+        cond_wait_res = fx_thread_timedwait_object(
             &cond->waitable, 
-            mutex, 
+            &attr, 
             tout
         );
     
         //
         // Mutex will be re-acquired regardless of timeout.
         //
-        const int mutex_wait_res = fx_mutex_acquire(mutex, NULL);
-
-        return (mutex_wait_res == FX_STATUS_OK) ? 
-            cond_wait_res : 
-            FX_COND_MUTEX_ERROR;;
+        return fx_cond_wait_complete(&attr, cond_wait_res);
     }
 }
@@ -47,14 +47,51 @@ FX_METADATA(({ implementation: [FX_EV_FLAGS, V1] }))
 typedef struct
 {
     unsigned int type;    //!< Options whether the flags should be cleared, etc.
-    uint_fast32_t flags;  //!< Requested flags to wait.
-    uint_fast32_t prev;   //!< Event flags state which unlocks the wait.
+    fx_ev_flags_mask_t flags;  //!< Requested flags to wait.
+    fx_ev_flags_mask_t prev;   //!< Event flags state which unlocks the wait.
 }
 fx_ev_flags_attr_t;
 
 #define wait_all(type) (((type) & FX_EV_FLAGS_AND) != 0)
 #define wait_any(type) (((type) & FX_EV_FLAGS_AND) == 0)
 
+lang_static_assert((FX_EV_FLAGS_BUCKETS & (FX_EV_FLAGS_BUCKETS - 1)) == 0);
+
+#if FX_EV_FLAGS_BUCKETS > 1
+
+//
+// Mask of flags belonging to specified bucket. Each bucket holds a range of 
+// adjacent bits, so, masks of neighbouring flags usually fit single bucket.
+//
+#define FX_EV_FLAGS_WIDTH (sizeof(fx_ev_flags_mask_t) * 8)
+#define FX_EV_FLAGS_BUCKET_WIDTH (FX_EV_FLAGS_WIDTH / FX_EV_FLAGS_BUCKETS)
+#define fx_evf_bucket_mask(i) \
+    ((~((fx_ev_flags_mask_t) 0) >> (FX_EV_FLAGS_WIDTH - \
+    FX_EV_FLAGS_BUCKET_WIDTH)) << ((i) * FX_EV_FLAGS_BUCKET_WIDTH))
+
+//
+// Gets queue for waiter requesting specified flags.
+//
+static fx_sync_waitable_t*
+fx_evf_get_queue(fx_ev_flags_t* evf, const fx_ev_flags_mask_t flags)
+{
+    unsigned int i;
+
+    for (i = 0; i < FX_EV_FLAGS_BUCKETS; ++i)
+    {
+        if ((flags & ~fx_evf_bucket_mask(i)) == 0)
+        {
+            return &evf->buckets[i];
+        }
+    }
+
+    return &evf->waitable;
+}
+
+#else
+#define fx_evf_get_queue(evf, flags) (&((evf)->waitable))
+#endif
+
 //
 // Internal function used to check event flags state and determine should the 
 // waiter put itself into waiters queue or the request may be satisfied 
@@ -76,7 +113,7 @@ fx_evf_test_and_wait(
 
     fx_sync_waitable_lock(object);
     {
-        const uint_fast32_t intersect = attr->flags & evf->flags;
+        const fx_ev_flags_mask_t intersect = attr->flags & evf->flags;
 
         if ((wait_all(attr->type) && intersect == attr->flags) || 
             (wait_any(attr->type) && intersect != 0))
@@ -90,7 +127,7 @@ fx_evf_test_and_wait(
         }
         else if (wait)
         {
-            _fx_sync_wait_start(object, wb);
+            _fx_sync_wait_start(fx_evf_get_queue(evf, attr->flags), wb);
         }
     }
     fx_sync_waitable_unlock(object);
@@ -106,6 +143,9 @@ fx_evf_test_and_wait(
 int 
 fx_ev_flags_init(fx_ev_flags_t* evf)
 {
+#if FX_EV_FLAGS_BUCKETS > 1
+    unsigned int i;
+#endif
     lang_param_assert(evf != NULL, FX_EV_FLAGS_INVALID_PTR);
 
     fx_rtp_init(&evf->rtp, FX_EV_FLAGS_MAGIC);
@@ -115,6 +155,18 @@ fx_ev_flags_init(fx_ev_flags_t* evf)
     // Both internal wait queues share single lock!
     //
     fx_sync_waitable_init(&evf->waitable, &evf->lock, fx_evf_test_and_wait);
+
+#if FX_EV_FLAGS_BUCKETS > 1
+    for (i = 0; i < FX_EV_FLAGS_BUCKETS; ++i)
+    {
+        fx_sync_waitable_init(
+            &evf->buckets[i], 
+            &evf->lock, 
+            fx_evf_test_and_wait
+        );
+    }
+#endif
+
     rtl_queue_init(&evf->temp);
     evf->flags = 0;
     return FX_EV_FLAGS_OK;
@@ -129,6 +181,9 @@ int
 fx_ev_flags_deinit(fx_ev_flags_t* evf)
 {
     fx_sched_state_t prev;
+#if FX_EV_FLAGS_BUCKETS > 1
+    unsigned int i;
+#endif
     lang_param_assert(evf != NULL, FX_EV_FLAGS_INVALID_PTR);
     lang_param_assert(fx_ev_flags_is_valid(evf), FX_EV_FLAGS_INVALID_OBJ);
 
@@ -136,11 +191,69 @@ fx_ev_flags_deinit(fx_ev_flags_t* evf)
     fx_rtp_deinit(&evf->rtp);
     fx_sync_waitable_lock(&evf->waitable);
     _fx_sync_wait_notify(&evf->waitable, FX_WAIT_DELETED, NULL);
+
+#if FX_EV_FLAGS_BUCKETS > 1
+    for (i = 0; i < FX_EV_FLAGS_BUCKETS; ++i)
+    {
+        _fx_sync_wait_notify(&evf->buckets[i], FX_WAIT_DELETED, NULL);
+    }
+#endif
+
     fx_sync_waitable_unlock(&evf->waitable);
     fx_sched_unlock(prev);
     return FX_EV_FLAGS_OK;
 }
 
+//
+// Moves waiters which are satisfied by current flags state from specified 
+// queue to temporary queue.
+// @return Flags to be consumed by satisfied waiters.
+//
+static fx_ev_flags_mask_t
+fx_evf_collect(fx_ev_flags_t* evf, fx_sync_waitable_t* queue)
+{
+    rtl_queue_t* const head = fx_sync_waitable_as_queue(queue);
+    const rtl_queue_t* n = rtl_queue_first(head);
+    fx_ev_flags_mask_t flags_to_clear = 0;
+
+    while (n != head) 
+    {
+        fx_sync_wait_block_t* const wb = fx_sync_queue_item_as_wb(n);
+        fx_ev_flags_attr_t* const attr = fx_sync_wait_block_get_attr(wb);
+        const fx_ev_flags_mask_t intersect = attr->flags & evf->flags;
+        n = rtl_queue_next(n);
+
+        //
+        // If wait condition is satisfied.
+        //
+        if ((wait_all(attr->type) && intersect == attr->flags) || 
+            (wait_any(attr->type) && intersect != 0))
+        {
+            //
+            // If waiter consume flags, mark them to be reset.
+            //
+            if (attr->type & FX_EV_FLAGS_CLEAR)
+            {
+                flags_to_clear |= attr->flags;
+            }
+
+            //
+            // Provide flags state which satisfies the wait.
+            //
+            attr->prev = evf->flags;
+            
+            //
+            // Move wait block to temporary queue holding all items to be 
+            // resumed.
+            //
+            rtl_queue_remove(fx_sync_wb_as_queue_item(wb));
+            rtl_queue_insert(&evf->temp, fx_sync_wb_as_queue_item(wb));
+        }
+    }
+
+    return flags_to_clear;
+}
+
 //!
 //! Setting or clearing specified event flags.
 //! @param [in] evf Pointer to event flags object.
@@ -150,7 +263,7 @@ fx_ev_flags_deinit(fx_ev_flags_t* evf)
 //! @return FX_EV_FLAGS_OK in case of success, error code otherwise.
 //!
 int  
-fx_ev_flags_set(fx_ev_flags_t* evf, uint_fast32_t flags, bool set)
+fx_ev_flags_set(fx_ev_flags_t* evf, fx_ev_flags_mask_t flags, bool set)
 {
     fx_sched_state_t prev;
     lang_param_assert(evf != NULL, FX_EV_FLAGS_INVALID_PTR);
@@ -162,45 +275,28 @@ fx_ev_flags_set(fx_ev_flags_t* evf, uint_fast32_t flags, bool set)
 
     if (set)
     {
-        rtl_queue_t* const head = fx_sync_waitable_as_queue(&evf->waitable);
-        const rtl_queue_t* n = rtl_queue_first(head);
-        uint_fast32_t flags_to_clear = 0;
+        fx_ev_flags_mask_t flags_to_clear = 0;
+#if FX_EV_FLAGS_BUCKETS > 1
+        unsigned int i;
+#endif
         evf->flags |= flags;
 
-        while (n != head) 
+#if FX_EV_FLAGS_BUCKETS > 1
+        //
+        // Waiters from the bucket may be satisfied only if some of its flags 
+        // are being set. Waiters requesting flags from different buckets are
+        // always examined.
+        //
+        for (i = 0; i < FX_EV_FLAGS_BUCKETS; ++i)
         {
-            fx_sync_wait_block_t* const wb = fx_sync_queue_item_as_wb(n);
-            fx_ev_flags_attr_t* const attr = fx_sync_wait_block_get_attr(wb);
-            const uint_fast32_t intersect = attr->flags & evf->flags;
-            n = rtl_queue_next(n);
-
-            //
-            // If wait condition is satisfied.
-            //
-            if ((wait_all(attr->type) && intersect == attr->flags) || 
-                (wait_any(attr->type) && intersect != 0))
+            if (flags & fx_evf_bucket_mask(i))
             {
-                //
-                // If waiter consume flags, mark them to be reset.
-                //
-                if (attr->type & FX_EV_FLAGS_CLEAR)
-                {
-                    flags_to_clear |= attr->flags;
-                }
-
-                //
-                // Provide flags state which satisfies the wait.
-                //
-                attr->prev = evf->flags;
-                
-                //
-                // Move wait block to temporary queue holding all items to be 
-                // resumed.
-                //
-                rtl_queue_remove(fx_sync_wb_as_queue_item(wb));
-                rtl_queue_insert(&evf->temp, fx_sync_wb_as_queue_item(wb));
+                flags_to_clear |= fx_evf_collect(evf, &evf->buckets[i]);
             }
         }
+#endif
+
+        flags_to_clear |= fx_evf_collect(evf, &evf->waitable);
 
         //
         // Now temporary queue holds all the items should be resumed and we have
@@ -224,7 +320,7 @@ fx_ev_flags_set(fx_ev_flags_t* evf, uint_fast32_t flags, bool set)
         {
             const rtl_queue_t* n = rtl_queue_first(&evf->temp);
             fx_sync_wait_block_t* const wb = fx_sync_queue_item_as_wb(n);
-            _fx_sync_wait_notify(&evf->waitable, FX_WAIT_SATISFIED, wb);
+            _fx_sync_wait_notify(wb->waitable, FX_WAIT_SATISFIED, wb);
         }
     }
     else
@@ -252,9 +348,9 @@ fx_ev_flags_set(fx_ev_flags_t* evf, uint_fast32_t flags, bool set)
 int 
 fx_ev_flags_wait(
     fx_ev_flags_t* evf, 
-    const uint_fast32_t req_flags, 
+    const fx_ev_flags_mask_t req_flags, 
     const unsigned int option, 
-    uint_fast32_t* state,
+    fx_ev_flags_mask_t* state,
     fx_event_t* cancel_ev)
 {
     fx_ev_flags_attr_t attr;
@@ -310,9 +406,9 @@ fx_ev_flags_wait(
 int 
 fx_ev_flags_timedwait(
     fx_ev_flags_t* evf, 
-    const uint_fast32_t req_flags, 
+    const fx_ev_flags_mask_t req_flags, 
     const unsigned int option, 
-    uint_fast32_t* state, 
+    fx_ev_flags_mask_t* state, 
     uint32_t tout)
 {
     fx_ev_flags_attr_t attr;
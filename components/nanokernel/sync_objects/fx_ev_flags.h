@@ -36,6 +36,19 @@
 #include FX_INTERFACE(FX_THREAD)
 #include FX_INTERFACE(RTL_QUEUE)
 
+#ifndef FX_EV_FLAGS_BUCKETS
+#define FX_EV_FLAGS_BUCKETS 1
+#endif
+
+//!
+//! Flags group type.
+//!
+#if defined FX_EV_FLAGS_64BIT
+typedef uint64_t fx_ev_flags_mask_t;
+#else
+typedef uint_fast32_t fx_ev_flags_mask_t;
+#endif
+
 //!
 //! Error codes.
 //! 
@@ -63,12 +76,19 @@ enum
 //!
 //! Event flags representation. 
 //! It ises temporary queue for items to be notified.
+//! If buckets are enabled, flag bits are split into FX_EV_FLAGS_BUCKETS 
+//! ranges of adjacent bits. Waiters whose requested flags belong to single
+//! range are queued in its bucket, all other waiters are queued in the main
+//! waitable. Only buckets containing flags being set are examined.
 //!
 typedef struct
 {
     fx_sync_waitable_t waitable;
+#if FX_EV_FLAGS_BUCKETS > 1
+    fx_sync_waitable_t buckets[FX_EV_FLAGS_BUCKETS];
+#endif
     rtl_queue_t temp;
-    uint_fast32_t flags;
+    fx_ev_flags_mask_t flags;
     fx_rtp_t rtp;
     lock_t lock;
 } 
@@ -78,20 +98,28 @@ int fx_ev_flags_init(fx_ev_flags_t* evf);
 int fx_ev_flags_deinit(fx_ev_flags_t* evf);
 int fx_ev_flags_wait(
     fx_ev_flags_t* evf, 
-    const uint_fast32_t req_flags, 
+    const fx_ev_flags_mask_t req_flags, 
     const unsigned int option, 
-    uint_fast32_t* state, 
+    fx_ev_flags_mask_t* state, 
     fx_event_t* cancel_ev
 );
 int fx_ev_flags_timedwait(
     fx_ev_flags_t* evf, 
-    const uint_fast32_t req_flags, 
+    const fx_ev_flags_mask_t req_flags, 
     const unsigned int option, 
-    uint_fast32_t* state, 
+    fx_ev_flags_mask_t* state, 
     uint32_t tout
 );
-int fx_ev_flags_set(fx_ev_flags_t* evf, uint_fast32_t flags, bool type);
+int fx_ev_flags_set(fx_ev_flags_t* evf, fx_ev_flags_mask_t flags, bool type);
 
 FX_METADATA(({ interface: [FX_EV_FLAGS, V1] }))
 
+FX_METADATA(({ options: [
+    FX_EV_FLAGS_BUCKETS: {
+        type: int, range: [1, 16], default: 1,
+        description: "Number of waiter queues (power of two, 1 disables)."},
+    FX_EV_FLAGS_64BIT: {
+        type: int, range: [0, 1], default: 0,
+        description: "Use 64-bit flags groups."}]}))
+
 #endif
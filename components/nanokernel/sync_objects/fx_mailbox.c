@@ -0,0 +1,359 @@
+/** 
+  ******************************************************************************
+  *  @file   fx_mailbox.c
+  *  @brief  Implementation of mailbox.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(FX_MAILBOX)
+#include FX_INTERFACE(HW_CPU)
+
+FX_METADATA(({ implementation: [FX_MAILBOX, V1] }))
+
+#define fx_mailbox_is_valid(mb) (fx_rtp_check((&((mb)->rtp)), FX_MAILBOX_MAGIC))
+#define fx_mailbox_msg_to_hdr(msg) (((fx_mailbox_hdr_t*) (msg)) - 1)
+#define fx_mailbox_hdr_to_msg(hdr) ((void*) (((fx_mailbox_hdr_t*) (hdr)) + 1))
+
+//!
+//! Test and wait function. Mailbox is signaled while it contains messages,
+//! the first message is removed from the mailbox and given to the caller.
+//! @param [in] object Mailbox object to be tested.
+//! @param [in] wb Wait block to be inserted into queue if mailbox is empty.
+//! @param [in] wait Wait option.
+//! @return true in case of object was signaled, false otherwise.
+//! @remark SPL = SCHED_LEVEL
+//!
+static bool
+fx_mailbox_test_and_wait(
+    fx_sync_waitable_t* object,
+    fx_sync_wait_block_t* wb,
+    const bool wait)
+{
+    fx_mailbox_t* const mb = lang_containing_record(
+        object,
+        fx_mailbox_t,
+        waitable
+    );
+    bool nonempty = false;
+
+    fx_sync_waitable_lock(object);
+    nonempty = !rtl_list_empty(&mb->msgs);
+
+    if (nonempty)
+    {
+        void** const usr_storage = (void**) fx_sync_wait_block_get_attr(wb);
+        rtl_list_linkage_t* const first = rtl_list_first(&mb->msgs);
+
+        rtl_list_remove(first);
+        --mb->msgs_num;
+        *usr_storage = fx_mailbox_hdr_to_msg(
+            rtl_list_entry(first, fx_mailbox_hdr_t, link)
+        );
+    }
+    else if (wait)
+    {
+        _fx_sync_wait_start(object, wb);
+    }
+
+    fx_sync_waitable_unlock(object);
+    return nonempty;
+}
+
+//
+// Initializes header of newly allocated block and returns message pointer.
+//
+static void*
+fx_mailbox_msg_init(void* blk)
+{
+    fx_mailbox_hdr_t* const hdr = (fx_mailbox_hdr_t*) blk;
+
+    hdr->link.next = hdr->link.prev = NULL;
+    hdr->refs = 1;
+    return fx_mailbox_hdr_to_msg(hdr);
+}
+
+//!
+//! Initializes the mailbox.
+//! @param [in,out] mb Mailbox object to be initialized.
+//! @param [in] bp Block pool used for message allocation. Pool block size
+//! should be at least FX_MAILBOX_BLOCK_SIZE(max_message_size).
+//! @param [in] p Receivers notification policy.
+//! @return FX_MAILBOX_OK in case of success, error code otherwise.
+//!
+int
+fx_mailbox_init(fx_mailbox_t* mb, fx_block_pool_t* bp, fx_sync_policy_t p)
+{
+    lang_param_assert(mb != NULL, FX_MAILBOX_INVALID_PTR);
+    lang_param_assert(bp != NULL, FX_MAILBOX_INVALID_PTR);
+    lang_param_assert(p < FX_SYNC_POLICY_MAX, FX_MAILBOX_UNSUPPORTED_POLICY);
+
+    fx_spl_spinlock_init(&mb->lock);
+    fx_sync_waitable_init(&mb->waitable, &mb->lock, fx_mailbox_test_and_wait);
+    rtl_list_init(&mb->msgs);
+    mb->msgs_num = 0;
+    mb->pool = bp;
+    mb->policy = p;
+    fx_rtp_init(&mb->rtp, FX_MAILBOX_MAGIC);
+    return FX_MAILBOX_OK;
+}
+
+//!
+//! Destructor of the mailbox. Waiting receivers are released with appropriate
+//! status, messages remaining in the mailbox are freed.
+//! @param [in,out] mb Mailbox object to be deinitialized.
+//! @return FX_MAILBOX_OK in case of success, error code otherwise.
+//!
+int
+fx_mailbox_deinit(fx_mailbox_t* mb)
+{
+    fx_sched_state_t prev;
+    rtl_list_t msgs;
+    lang_param_assert(mb != NULL, FX_MAILBOX_INVALID_PTR);
+    lang_param_assert(fx_mailbox_is_valid(mb), FX_MAILBOX_INVALID_OBJ);
+
+    rtl_list_init(&msgs);
+    fx_sched_lock(&prev);
+    fx_rtp_deinit(&mb->rtp);
+    fx_sync_waitable_lock(&mb->waitable);
+    _fx_sync_wait_notify(&mb->waitable, FX_WAIT_DELETED, NULL);
+
+    //
+    // Pending messages are moved into the local list and freed after the
+    // lock is released, since freeing may release blocked allocators.
+    //
+    while (!rtl_list_empty(&mb->msgs))
+    {
+        rtl_list_linkage_t* const first = rtl_list_first(&mb->msgs);
+        rtl_list_remove(first);
+        rtl_list_insert(rtl_list_last(&msgs), first);
+    }
+
+    mb->msgs_num = 0;
+    fx_sync_waitable_unlock(&mb->waitable);
+    fx_sched_unlock(prev);
+
+    while (!rtl_list_empty(&msgs))
+    {
+        rtl_list_linkage_t* const first = rtl_list_first(&msgs);
+        rtl_list_remove(first);
+        (void) fx_block_pool_release(
+            rtl_list_entry(first, fx_mailbox_hdr_t, link)
+        );
+    }
+
+    return FX_MAILBOX_OK;
+}
+
+//!
+//! Allocates message from the mailbox's pool. If there are no free blocks,
+//! calling thread is blocked until some message is freed or cancel event is
+//! set.
+//! @param [in] mb Mailbox object.
+//! @param [out] msg Pointer to location where message pointer is stored.
+//! @param [in] cancel_ev Optional cancel event (can be NULL).
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int
+fx_mailbox_alloc(fx_mailbox_t* mb, void** msg, fx_event_t* cancel_ev)
+{
+    void* blk = NULL;
+    int error;
+    lang_param_assert(mb != NULL, FX_MAILBOX_INVALID_PTR);
+    lang_param_assert(fx_mailbox_is_valid(mb), FX_MAILBOX_INVALID_OBJ);
+    lang_param_assert(msg != NULL, FX_MAILBOX_INVALID_PTR);
+
+    error = fx_block_pool_alloc(mb->pool, &blk, cancel_ev);
+
+    if (error == FX_STATUS_OK)
+    {
+        *msg = fx_mailbox_msg_init(blk);
+    }
+
+    return error;
+}
+
+//!
+//! Allocates message from the mailbox's pool with timeout.
+//! @param [in] mb Mailbox object.
+//! @param [out] msg Pointer to location where message pointer is stored.
+//! @param [in] tout Timeout (in ticks) or FX_THREAD_INFINITE_TIMEOUT value.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int
+fx_mailbox_timedalloc(fx_mailbox_t* mb, void** msg, uint32_t tout)
+{
+    void* blk = NULL;
+    int error;
+    lang_param_assert(mb != NULL, FX_MAILBOX_INVALID_PTR);
+    lang_param_assert(fx_mailbox_is_valid(mb), FX_MAILBOX_INVALID_OBJ);
+    lang_param_assert(msg != NULL, FX_MAILBOX_INVALID_PTR);
+
+    error = fx_block_pool_timedalloc(mb->pool, &blk, tout);
+
+    if (error == FX_STATUS_OK)
+    {
+        *msg = fx_mailbox_msg_init(blk);
+    }
+
+    return error;
+}
+
+//!
+//! Sends message to the mailbox. If there are waiting receivers, message is
+//! given directly to one of them, otherwise it is linked into the mailbox.
+//! This function never blocks. Ownership of the message is transferred to
+//! the receiver, so, the sender must not access the message after this call.
+//! @param [in] mb Mailbox object.
+//! @param [in] msg Message allocated by @ref fx_mailbox_alloc.
+//! @return FX_MAILBOX_OK in case of success, error code otherwise.
+//!
+int
+fx_mailbox_send(fx_mailbox_t* mb, void* msg)
+{
+    fx_sched_state_t prev;
+    lang_param_assert(mb != NULL, FX_MAILBOX_INVALID_PTR);
+    lang_param_assert(fx_mailbox_is_valid(mb), FX_MAILBOX_INVALID_OBJ);
+    lang_param_assert(msg != NULL, FX_MAILBOX_INVALID_PTR);
+
+    fx_sched_lock(&prev);
+    fx_sync_waitable_lock(&mb->waitable);
+
+    if (_fx_sync_waitable_nonempty(&mb->waitable))
+    {
+        fx_sync_wait_block_t* const wb = _fx_sync_wait_block_get(
+            &mb->waitable,
+            mb->policy
+        );
+        void** const usr_storage = (void**) fx_sync_wait_block_get_attr(wb);
+        *usr_storage = msg;
+        _fx_sync_wait_notify(&mb->waitable, FX_WAIT_SATISFIED, wb);
+    }
+    else
+    {
+        fx_mailbox_hdr_t* const hdr = fx_mailbox_msg_to_hdr(msg);
+        rtl_list_insert(rtl_list_last(&mb->msgs), &hdr->link);
+        ++mb->msgs_num;
+    }
+
+    fx_sync_waitable_unlock(&mb->waitable);
+    fx_sched_unlock(prev);
+    return FX_MAILBOX_OK;
+}
+
+//!
+//! Receives message from the mailbox. If the mailbox is empty, calling thread
+//! is blocked until some message is sent or cancel event is set.
+//! @param [in] mb Mailbox object.
+//! @param [out] msg Pointer to location where message pointer is stored.
+//! @param [in] cancel_ev Optional cancel event (can be NULL).
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int
+fx_mailbox_receive(fx_mailbox_t* mb, void** msg, fx_event_t* cancel_ev)
+{
+    lang_param_assert(mb != NULL, FX_MAILBOX_INVALID_PTR);
+    lang_param_assert(fx_mailbox_is_valid(mb), FX_MAILBOX_INVALID_OBJ);
+    lang_param_assert(msg != NULL, FX_MAILBOX_INVALID_PTR);
+
+    return fx_thread_wait_object(&mb->waitable, msg, cancel_ev);
+}
+
+//!
+//! Receives message from the mailbox with timeout.
+//! @param [in] mb Mailbox object.
+//! @param [out] msg Pointer to location where message pointer is stored.
+//! @param [in] tout Timeout (in ticks) or FX_THREAD_INFINITE_TIMEOUT value.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int
+fx_mailbox_timedreceive(fx_mailbox_t* mb, void** msg, uint32_t tout)
+{
+    lang_param_assert(mb != NULL, FX_MAILBOX_INVALID_PTR);
+    lang_param_assert(fx_mailbox_is_valid(mb), FX_MAILBOX_INVALID_OBJ);
+    lang_param_assert(msg != NULL, FX_MAILBOX_INVALID_PTR);
+
+    return fx_thread_timedwait_object(&mb->waitable, msg, tout);
+}
+
+//!
+//! Adds reference to the message. It is used when received message is shared
+//! by several consumers, each of them should free the message when it is no
+//! longer needed.
+//! @param [in] msg Message.
+//! @return FX_MAILBOX_OK in case of success, error code otherwise.
+//!
+int
+fx_mailbox_ref(void* msg)
+{
+    lang_param_assert(msg != NULL, FX_MAILBOX_INVALID_PTR);
+
+    (void) hw_cpu_atomic_inc(&fx_mailbox_msg_to_hdr(msg)->refs);
+    return FX_MAILBOX_OK;
+}
+
+//!
+//! Drops reference to the message. When the last reference is dropped, the
+//! block is returned into its pool. If there are threads waiting for free
+//! block, the block is given directly to one of them.
+//! @param [in] msg Message.
+//! @return FX_MAILBOX_OK in case of success, error code otherwise.
+//!
+int
+fx_mailbox_free(void* msg)
+{
+    fx_mailbox_hdr_t* hdr = NULL;
+    int error = FX_MAILBOX_OK;
+    lang_param_assert(msg != NULL, FX_MAILBOX_INVALID_PTR);
+
+    hdr = fx_mailbox_msg_to_hdr(msg);
+
+    if (hw_cpu_atomic_dec(&hdr->refs) == 0)
+    {
+        error = fx_block_pool_release(hdr);
+    }
+
+    return error;
+}
+
+//!
+//! Gets number of messages in the mailbox.
+//! @param [in] mb Mailbox object.
+//! @param [out] count Pointer to location where number of messages is stored.
+//! @return FX_MAILBOX_OK in case of success, error code otherwise.
+//!
+int
+fx_mailbox_get_count(fx_mailbox_t* mb, unsigned int* count)
+{
+    lang_param_assert(mb != NULL, FX_MAILBOX_INVALID_PTR);
+    lang_param_assert(count != NULL, FX_MAILBOX_INVALID_PTR);
+    lang_param_assert(fx_mailbox_is_valid(mb), FX_MAILBOX_INVALID_OBJ);
+
+    *count = mb->msgs_num;
+    return FX_MAILBOX_OK;
+}
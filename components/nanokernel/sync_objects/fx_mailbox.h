@@ -0,0 +1,102 @@
+#ifndef _FX_MAILBOX_V1_HEADER_
+#define _FX_MAILBOX_V1_HEADER_
+
+/** 
+  ******************************************************************************
+  *  @file   fx_mailbox.h
+  *  @brief  Mailbox transferring memory blocks between threads.
+  *  Messages are blocks allocated from the block pool associated with the
+  *  mailbox. The block is passed by reference, so, message data is never
+  *  copied. Queued messages are linked through their headers, so, sending
+  *  never blocks. Freed message is returned into its pool, blocked allocator
+  *  (if any) gets the block directly.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(LANG_TYPES)
+#include FX_INTERFACE(FX_SYNC)
+#include FX_INTERFACE(FX_THREAD)
+#include FX_INTERFACE(FX_RTP)
+#include FX_INTERFACE(FX_BLOCK_POOL)
+#include FX_INTERFACE(RTL_LIST)
+
+enum
+{
+    FX_MAILBOX_MAGIC = 0x4D424F58, // MBOX
+    FX_MAILBOX_OK = FX_STATUS_OK,
+    FX_MAILBOX_INVALID_PTR = FX_BLOCK_POOL_ERR_MAX,
+    FX_MAILBOX_INVALID_OBJ,
+    FX_MAILBOX_UNSUPPORTED_POLICY,
+    FX_MAILBOX_ERR_MAX
+};
+
+//!
+//! Message header. It is placed at the beginning of the pool block, message
+//! data follows the header. Reference count is used when the message is
+//! shared by several consumers, block is freed when the last reference is
+//! dropped.
+//!
+typedef struct
+{
+    rtl_list_linkage_t link;
+    volatile unsigned int refs;
+}
+fx_mailbox_hdr_t;
+
+//!
+//! Mailbox representation.
+//!
+typedef struct
+{
+    fx_sync_waitable_t waitable;
+    lock_t lock;
+    fx_block_pool_t* pool;
+    rtl_list_t msgs;
+    unsigned int msgs_num;
+    fx_sync_policy_t policy;
+    fx_rtp_t rtp;
+}
+fx_mailbox_t;
+
+//!
+//! Block size to be used for pool initialization in order to carry messages
+//! of specified size.
+//!
+#define FX_MAILBOX_BLOCK_SIZE(msg_sz) (sizeof(fx_mailbox_hdr_t) + (msg_sz))
+
+int fx_mailbox_init(fx_mailbox_t* mb, fx_block_pool_t* bp, fx_sync_policy_t p);
+int fx_mailbox_deinit(fx_mailbox_t* mb);
+int fx_mailbox_alloc(fx_mailbox_t* mb, void** msg, fx_event_t* cancel_ev);
+int fx_mailbox_timedalloc(fx_mailbox_t* mb, void** msg, uint32_t tout);
+int fx_mailbox_send(fx_mailbox_t* mb, void* msg);
+int fx_mailbox_receive(fx_mailbox_t* mb, void** msg, fx_event_t* cancel_ev);
+int fx_mailbox_timedreceive(fx_mailbox_t* mb, void** msg, uint32_t tout);
+int fx_mailbox_ref(void* msg);
+int fx_mailbox_free(void* msg);
+int fx_mailbox_get_count(fx_mailbox_t* mb, unsigned int* count);
+
+FX_METADATA(({ interface: [FX_MAILBOX, V1] }))
+
+#endif
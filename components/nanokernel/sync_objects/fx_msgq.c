@@ -39,6 +39,9 @@ FX_METADATA(({ implementation: [FX_MSGQ, V1] }))
 //! @param [in] sz Maximum item count that may be stored in the queue.
 //! @param [in] p Waiter notification policy.
 //! @return FX_MSGQ_OK in case of success, error code otherwise.
+//! @remark Receive wait attribute of the queue is fx_msgq_recv_attr_t object 
+//! (this should be taken into account when the queue is used in multiple 
+//! wait).
 //! @sa fx_msgq_deinit
 //!
 int 
@@ -53,7 +56,7 @@ fx_msgq_init(fx_msgq_t* msgq, uintptr_t* buf, unsigned sz, fx_sync_policy_t p)
         FX_MSGQ_INVALID_BUF
     );
 
-    return fx_msgq_core_init(msgq, buf, sz, p);
+    return fx_msgq_core_init(msgq, buf, sz, p, true);
 }
 
 //!
@@ -176,6 +179,38 @@ fx_msgq_back_timedsend(fx_msgq_t* msgq, uintptr_t msg, uint32_t tout)
     return wait_res; 
 }
 
+//!
+//! Send message into back of the queue without blocking. If the queue is full
+//! the oldest message is discarded, so, the queue always contains the most 
+//! recent messages. Blocked senders (if any) remain blocked.
+//! Since the function never blocks, it may be used by interrupt handlers in 
+//! unified SPL scheme (where ISRs run at DISPATCH level), in segmented scheme 
+//! ISRs should call it from DPC.
+//! @param [in] msgq Message queue to send to.
+//! @param [in] msg Message data. 
+//! @param [out] overwritten Optional pointer (may be NULL) to location where 
+//! true is stored if the oldest message has been discarded.
+//! @return FX_MSGQ_OK in case of success, error code otherwise.
+//! @remark SPL <= DISPATCH.
+//! @sa fx_msgq_receive_ex
+//!
+int 
+fx_msgq_overwrite_send(fx_msgq_t* msgq, uintptr_t msg, bool* overwritten)
+{
+    bool discarded = false;
+    lang_param_assert(msgq != NULL, FX_MSGQ_INVALID_PTR);
+    lang_param_assert(fx_msgq_is_valid(msgq), FX_MSGQ_INVALID_OBJ); 
+
+    discarded = fx_msgq_core_overwrite(msgq, msg);
+
+    if (overwritten != NULL)
+    {
+        *overwritten = discarded;
+    }
+
+    return FX_MSGQ_OK;
+}
+
 //!
 //! Receive message from the queue. If the queue is empty, calling thread is 
 //! blocked until some other thread sends data to the queue or until cancel 
@@ -190,11 +225,14 @@ fx_msgq_back_timedsend(fx_msgq_t* msgq, uintptr_t msg, uint32_t tout)
 int 
 fx_msgq_receive(fx_msgq_t* msgq, uintptr_t* msg, fx_event_t* cancel_event)
 {
+    fx_msgq_recv_attr_t attr;
     lang_param_assert(msgq != NULL, FX_MSGQ_INVALID_PTR);
     lang_param_assert(fx_msgq_is_valid(msgq), FX_MSGQ_INVALID_OBJ); 
     lang_param_assert(msg != NULL, FX_MSGQ_INVALID_BUF); 
 
-    return fx_thread_wait_object(&msgq->recv_wtbl, msg, cancel_event);
+    attr.buf = msg;
+    attr.dropped = NULL;
+    return fx_thread_wait_object(&msgq->recv_wtbl, &attr, cancel_event);
 }
 
 //!
@@ -210,9 +248,268 @@ fx_msgq_receive(fx_msgq_t* msgq, uintptr_t* msg, fx_event_t* cancel_event)
 int 
 fx_msgq_timedreceive(fx_msgq_t* msgq, uintptr_t* msg, uint32_t tout)
 {
+    fx_msgq_recv_attr_t attr;
+    lang_param_assert(msgq != NULL, FX_MSGQ_INVALID_PTR);
+    lang_param_assert(fx_msgq_is_valid(msgq), FX_MSGQ_INVALID_OBJ); 
+    lang_param_assert(msg != NULL, FX_MSGQ_INVALID_BUF); 
+
+    attr.buf = msg;
+    attr.dropped = NULL;
+    return fx_thread_timedwait_object(&msgq->recv_wtbl, &attr, tout);
+}
+
+//!
+//! Receive message from the queue along with number of messages discarded by
+//! overwrite send since the previous message was taken from the queue (i.e. 
+//! lost messages which preceded the received one). Both values are obtained 
+//! atomically, so, the number is exact even if there are other receivers and
+//! senders. Otherwise the function is the same as fx_msgq_receive.
+//! @param [in] msgq Message queue to receive from.
+//! @param [out] msg Message buffer to be filled from queue. 
+//! @param [out] dropped Pointer to location where number of discarded 
+//! messages is stored.
+//! @param [in] cancel_ev Event which cancels this wait operation if set 
+//! during waiting.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//! @sa fx_msgq_overwrite_send
+//!
+int 
+fx_msgq_receive_ex(
+    fx_msgq_t* msgq, 
+    uintptr_t* msg, 
+    uint32_t* dropped, 
+    fx_event_t* cancel_ev)
+{
+    fx_msgq_recv_attr_t attr;
+    lang_param_assert(msgq != NULL, FX_MSGQ_INVALID_PTR);
+    lang_param_assert(fx_msgq_is_valid(msgq), FX_MSGQ_INVALID_OBJ); 
+    lang_param_assert(msg != NULL, FX_MSGQ_INVALID_BUF); 
+    lang_param_assert(dropped != NULL, FX_MSGQ_INVALID_PTR); 
+
+    attr.buf = msg;
+    attr.dropped = dropped;
+    return fx_thread_wait_object(&msgq->recv_wtbl, &attr, cancel_ev);
+}
+
+//!
+//! Receive message from the queue along with number of discarded messages 
+//! with timeout.
+//! @param [in] msgq Message queue to receive from.
+//! @param [out] msg Message buffer to be filled from queue. 
+//! @param [out] dropped Pointer to location where number of messages 
+//! discarded before the received one is stored.
+//! @param [in] tout Timeout (in ticks) or FX_THREAD_INFINITE_TIMEOUT value.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//! @sa fx_msgq_receive_ex
+//!
+int 
+fx_msgq_timedreceive_ex(
+    fx_msgq_t* msgq, 
+    uintptr_t* msg, 
+    uint32_t* dropped, 
+    uint32_t tout)
+{
+    fx_msgq_recv_attr_t attr;
     lang_param_assert(msgq != NULL, FX_MSGQ_INVALID_PTR);
     lang_param_assert(fx_msgq_is_valid(msgq), FX_MSGQ_INVALID_OBJ); 
     lang_param_assert(msg != NULL, FX_MSGQ_INVALID_BUF); 
+    lang_param_assert(dropped != NULL, FX_MSGQ_INVALID_PTR); 
+
+    attr.buf = msg;
+    attr.dropped = dropped;
+    return fx_thread_timedwait_object(&msgq->recv_wtbl, &attr, tout);
+}
+
+//!
+//! Send batch of messages into back of the queue. 
+//! As many messages as possible are sent in single critical section. If the 
+//! queue is full, calling thread is blocked until the first message is sent 
+//! or until cancel event is set, the rest of the batch is sent without 
+//! waiting. So, the batch may be sent partially.
+//! @param [in] msgq Message queue to send to.
+//! @param [in] msgs Messages to be sent.
+//! @param [in] n Number of messages to be sent.
+//! @param [out] sent Number of messages actually sent.
+//! @param [in] cancel_ev Event which cancels this wait operation if set 
+//! during waiting.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int 
+fx_msgq_send_n(
+    fx_msgq_t* msgq, 
+    const uintptr_t* msgs, 
+    unsigned int n, 
+    unsigned int* sent, 
+    fx_event_t* cancel_ev)
+{
+    int wait_res = FX_STATUS_OK;
+    unsigned int cnt = 0;
+    lang_param_assert(msgq != NULL, FX_MSGQ_INVALID_PTR);
+    lang_param_assert(fx_msgq_is_valid(msgq), FX_MSGQ_INVALID_OBJ); 
+    lang_param_assert(msgs != NULL, FX_MSGQ_INVALID_BUF); 
+    lang_param_assert(n > 0, FX_MSGQ_INVALID_BUF); 
+    lang_param_assert(sent != NULL, FX_MSGQ_INVALID_PTR);
+
+    cnt = fx_msgq_core_send_n(msgq, msgs, n);
+
+    if (cnt == 0)
+    {
+        fx_msgq_wait_attr_t attr;
+        attr.to_back = true;
+        attr.buf = &msgs[0];
+        wait_res = fx_thread_wait_object(&msgq->send_wtbl, &attr, cancel_ev);
+
+        if (wait_res == FX_STATUS_OK)
+        {
+            cnt = 1 + fx_msgq_core_send_n(msgq, msgs + 1, n - 1);
+        }
+    }
+
+    *sent = cnt;
+    return wait_res;
+}
+
+//!
+//! Send batch of messages into back of the queue with timeout. 
+//! @param [in] msgq Message queue to send to.
+//! @param [in] msgs Messages to be sent.
+//! @param [in] n Number of messages to be sent.
+//! @param [out] sent Number of messages actually sent.
+//! @param [in] tout Timeout (in ticks) or FX_THREAD_INFINITE_TIMEOUT value.
+//! Timeout is applied to the first message only.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int 
+fx_msgq_timedsend_n(
+    fx_msgq_t* msgq, 
+    const uintptr_t* msgs, 
+    unsigned int n, 
+    unsigned int* sent, 
+    uint32_t tout)
+{
+    int wait_res = FX_STATUS_OK;
+    unsigned int cnt = 0;
+    lang_param_assert(msgq != NULL, FX_MSGQ_INVALID_PTR);
+    lang_param_assert(fx_msgq_is_valid(msgq), FX_MSGQ_INVALID_OBJ); 
+    lang_param_assert(msgs != NULL, FX_MSGQ_INVALID_BUF); 
+    lang_param_assert(n > 0, FX_MSGQ_INVALID_BUF); 
+    lang_param_assert(sent != NULL, FX_MSGQ_INVALID_PTR);
+
+    cnt = fx_msgq_core_send_n(msgq, msgs, n);
+
+    if (cnt == 0)
+    {
+        fx_msgq_wait_attr_t attr;
+        attr.to_back = true;
+        attr.buf = &msgs[0];
+        wait_res = fx_thread_timedwait_object(&msgq->send_wtbl, &attr, tout);
+
+        if (wait_res == FX_STATUS_OK)
+        {
+            cnt = 1 + fx_msgq_core_send_n(msgq, msgs + 1, n - 1);
+        }
+    }
+
+    *sent = cnt;
+    return wait_res;
+}
+
+//!
+//! Receive batch of messages from the queue. 
+//! As many messages as available (up to n) are received in single critical 
+//! section. If the queue is empty, calling thread is blocked until the first 
+//! message is received or until cancel event is set, messages sent along 
+//! with the first one are received without waiting.
+//! @param [in] msgq Message queue to receive from.
+//! @param [out] msgs Message buffer to be filled from queue. 
+//! @param [in] n Buffer size in messages.
+//! @param [out] received Number of messages actually received.
+//! @param [in] cancel_ev Event which cancels this wait operation if set 
+//! during waiting.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int 
+fx_msgq_receive_n(
+    fx_msgq_t* msgq, 
+    uintptr_t* msgs, 
+    unsigned int n, 
+    unsigned int* received, 
+    fx_event_t* cancel_ev)
+{
+    int wait_res = FX_STATUS_OK;
+    unsigned int cnt = 0;
+    lang_param_assert(msgq != NULL, FX_MSGQ_INVALID_PTR);
+    lang_param_assert(fx_msgq_is_valid(msgq), FX_MSGQ_INVALID_OBJ); 
+    lang_param_assert(msgs != NULL, FX_MSGQ_INVALID_BUF); 
+    lang_param_assert(n > 0, FX_MSGQ_INVALID_BUF); 
+    lang_param_assert(received != NULL, FX_MSGQ_INVALID_PTR);
+
+    cnt = fx_msgq_core_receive_n(msgq, msgs, n);
+
+    if (cnt == 0)
+    {
+        fx_msgq_recv_attr_t attr;
+        attr.buf = &msgs[0];
+        attr.dropped = NULL;
+        wait_res = fx_thread_wait_object(&msgq->recv_wtbl, &attr, cancel_ev);
+
+        if (wait_res == FX_STATUS_OK)
+        {
+            cnt = 1 + fx_msgq_core_receive_n(msgq, msgs + 1, n - 1);
+        }
+    }
+
+    *received = cnt;
+    return wait_res;
+}
+
+//!
+//! Receive batch of messages from the queue with timeout. 
+//! @param [in] msgq Message queue to receive from.
+//! @param [out] msgs Message buffer to be filled from queue. 
+//! @param [in] n Buffer size in messages.
+//! @param [out] received Number of messages actually received.
+//! @param [in] tout Timeout (in ticks) or FX_THREAD_INFINITE_TIMEOUT value.
+//! Timeout is applied to the first message only.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int 
+fx_msgq_timedreceive_n(
+    fx_msgq_t* msgq, 
+    uintptr_t* msgs, 
+    unsigned int n, 
+    unsigned int* received, 
+    uint32_t tout)
+{
+    int wait_res = FX_STATUS_OK;
+    unsigned int cnt = 0;
+    lang_param_assert(msgq != NULL, FX_MSGQ_INVALID_PTR);
+    lang_param_assert(fx_msgq_is_valid(msgq), FX_MSGQ_INVALID_OBJ); 
+    lang_param_assert(msgs != NULL, FX_MSGQ_INVALID_BUF); 
+    lang_param_assert(n > 0, FX_MSGQ_INVALID_BUF); 
+    lang_param_assert(received != NULL, FX_MSGQ_INVALID_PTR);
+
+    cnt = fx_msgq_core_receive_n(msgq, msgs, n);
+
+    if (cnt == 0)
+    {
+        fx_msgq_recv_attr_t attr;
+        attr.buf = &msgs[0];
+        attr.dropped = NULL;
+        wait_res = fx_thread_timedwait_object(&msgq->recv_wtbl, &attr, tout);
+
+        if (wait_res == FX_STATUS_OK)
+        {
+            cnt = 1 + fx_msgq_core_receive_n(msgq, msgs + 1, n - 1);
+        }
+    }
 
-    return fx_thread_timedwait_object(&msgq->recv_wtbl, msg, tout);
+    *received = cnt;
+    return wait_res;
 }
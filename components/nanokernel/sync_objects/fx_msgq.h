@@ -57,7 +57,48 @@ int fx_msgq_back_send(fx_msgq_t* msgq, uintptr_t msg, fx_event_t* cancel_ev);
 int fx_msgq_front_timedsend(fx_msgq_t* msgq, uintptr_t msg, uint32_t tout);
 int fx_msgq_back_timedsend(fx_msgq_t* msgq, uintptr_t msg, uint32_t tout);
 int fx_msgq_timedreceive(fx_msgq_t* msgq, uintptr_t* msg, uint32_t tout);
+int fx_msgq_overwrite_send(fx_msgq_t* msgq, uintptr_t msg, bool* overwritten);
 int fx_msgq_receive(fx_msgq_t* msgq, uintptr_t* msg, fx_event_t* cancel_ev);
+int fx_msgq_receive_ex(
+  fx_msgq_t* msgq, 
+  uintptr_t* msg, 
+  uint32_t* dropped, 
+  fx_event_t* cancel_ev
+);
+int fx_msgq_timedreceive_ex(
+  fx_msgq_t* msgq, 
+  uintptr_t* msg, 
+  uint32_t* dropped, 
+  uint32_t tout
+);
+int fx_msgq_send_n(
+  fx_msgq_t* msgq, 
+  const uintptr_t* msgs, 
+  unsigned int n, 
+  unsigned int* sent, 
+  fx_event_t* cancel_ev
+);
+int fx_msgq_timedsend_n(
+  fx_msgq_t* msgq, 
+  const uintptr_t* msgs, 
+  unsigned int n, 
+  unsigned int* sent, 
+  uint32_t tout
+);
+int fx_msgq_receive_n(
+  fx_msgq_t* msgq, 
+  uintptr_t* msgs, 
+  unsigned int n, 
+  unsigned int* received, 
+  fx_event_t* cancel_ev
+);
+int fx_msgq_timedreceive_n(
+  fx_msgq_t* msgq, 
+  uintptr_t* msgs, 
+  unsigned int n, 
+  unsigned int* received, 
+  uint32_t tout
+);
 
 FX_METADATA(({ interface: [FX_MSGQ, V1] }))
 
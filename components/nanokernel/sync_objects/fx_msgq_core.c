@@ -32,6 +32,14 @@
 
 FX_METADATA(({ implementation: [FX_MSGQ_CORE, V1] }))
 
+//
+// Index wrapping. Indices are advanced by one, so, comparison is used instead
+// of modulo operation, which requires library call on cores without hardware 
+// divider.
+//
+#define _fx_msgq_next(msgq, i) ((i) + 1 == (msgq)->items_max ? 0 : (i) + 1)
+#define _fx_msgq_prev(msgq, i) ((i) == 0 ? (msgq)->items_max - 1 : (i) - 1)
+
 //
 // Helper function for actual data copying to the queue. 
 // Should be called with object locked.
@@ -45,20 +53,90 @@ _fx_msgq_put_msg(
     if (insert_to_back)
     {
         msgq->buf[msgq->head] = *data_ptr;
-        msgq->head = (msgq->head + 1) % msgq->items_max;
+        msgq->head = _fx_msgq_next(msgq, msgq->head);
     }
     else
     {
-        //
-        // Since queue pointers are wrapped around, it is prohibited to
-        // decrement pointers directly. Decrement should be performed as 
-        // addition of (queue_size - 1) and then wrap.
-        //
-        msgq->tail = (msgq->tail + (msgq->items_max - 1)) % msgq->items_max;
+        msgq->tail = _fx_msgq_prev(msgq, msgq->tail);
         msgq->buf[msgq->tail] = *data_ptr;
     }
 }
 
+//
+// Stores message into the buffer of the receiver specified by wait block. 
+// Messages discarded by overwrite send always precede the tail message, so, 
+// they are accounted to the receiver which takes the message from the tail 
+// (or the first message sent after the queue became empty).
+// Should be called with object locked.
+//
+static void
+_fx_msgq_deliver_msg(fx_msgq_t* msgq, fx_sync_wait_block_t* wb, uintptr_t msg)
+{
+    if (msgq->ext_attr)
+    {
+        fx_msgq_recv_attr_t* attr = fx_sync_wait_block_get_attr(wb);
+        *attr->buf = msg;
+
+        if (attr->dropped != NULL)
+        {
+            *attr->dropped = msgq->dropped;
+        }
+    }
+    else
+    {
+        uintptr_t* rcvr_buf = fx_sync_wait_block_get_attr(wb);
+        *rcvr_buf = msg;
+    }
+
+    msgq->dropped = 0;
+}
+
+//
+// Gives a message directly to the first blocked receiver and satisfies its 
+// wait. Receivers wait only while the queue is empty, so, there are no queued 
+// messages which should be received before this one.
+// Should be called with object locked and receivers waiting.
+//
+static void
+_fx_msgq_forward_msg(fx_msgq_t* msgq, const uintptr_t* const data_ptr)
+{
+    fx_sync_wait_block_t* rcvr = _fx_sync_wait_block_get(
+        &msgq->recv_wtbl, 
+        msgq->policy
+    );
+
+    _fx_msgq_deliver_msg(msgq, rcvr, *data_ptr);
+    _fx_sync_wait_notify(&msgq->recv_wtbl, FX_WAIT_SATISFIED, rcvr);
+    trace_queue_receive_forward(&msgq->trace_handle);
+}
+
+//
+// Moves messages of blocked senders into free slots of the queue and 
+// satisfies their waits.
+// Should be called with object locked.
+//
+static void
+_fx_msgq_accept_senders(fx_msgq_t* msgq)
+{
+    //
+    // Waitable lock is released in notify function after notification of 
+    // each waiter, so, queue state should be examined after each waiter is 
+    // released.
+    //
+    while ( msgq->items < msgq->items_max && 
+            _fx_sync_waitable_nonempty(&msgq->send_wtbl))
+    {
+        fx_sync_wait_block_t* sndr = _fx_sync_wait_block_get(
+            &msgq->send_wtbl, 
+            msgq->policy
+        );
+        fx_msgq_wait_attr_t* attr = fx_sync_wait_block_get_attr(sndr);
+        _fx_msgq_put_msg(msgq, attr->buf, attr->to_back);
+        ++msgq->items;
+        _fx_sync_wait_notify(&msgq->send_wtbl, FX_WAIT_SATISFIED, sndr);
+    }
+}
+
 //!
 //! Test and wait function for senders.
 //! @param [in] object Waitable object to be tested.
@@ -82,9 +160,11 @@ fx_msgq_test_and_wait_send(
     fx_sync_waitable_lock(object);
 
     //
-    // If queue is full just insert wait block and start waiting.
+    // If queue is full (and there are no receivers to take the message) just 
+    // insert wait block and start waiting.
     //
-    if (msgq->items == msgq->items_max)
+    if (msgq->items == msgq->items_max && 
+        !_fx_sync_waitable_nonempty(&msgq->recv_wtbl))
     {
         if (wait)
         {
@@ -95,21 +175,14 @@ fx_msgq_test_and_wait_send(
     else
     {
         //
-        // If queue is empty and there are receivers just copy data item 
-        // directly into receiver's buffer and satisfy wait.
+        // If there are receivers just copy data item directly into receiver's
+        // buffer and satisfy wait.
         //
         fx_msgq_wait_attr_t* attr = fx_sync_wait_block_get_attr(wb);
 
-        if (msgq->items == 0 && _fx_sync_waitable_nonempty(&msgq->recv_wtbl))
+        if (_fx_sync_waitable_nonempty(&msgq->recv_wtbl))
         {
-            fx_sync_wait_block_t* rcvr = _fx_sync_wait_block_get(
-                &msgq->recv_wtbl, 
-                msgq->policy
-            );
-            uintptr_t* rcvr_buf = fx_sync_wait_block_get_attr(rcvr);
-            *rcvr_buf = *attr->buf;
-            _fx_sync_wait_notify(&msgq->recv_wtbl, FX_WAIT_SATISFIED, rcvr);
-            trace_queue_receive_forward(&msgq->trace_handle);
+            _fx_msgq_forward_msg(msgq, attr->buf);
         }
         //
         // In all other cases copy value into queue.
@@ -163,9 +236,8 @@ fx_msgq_test_and_wait_recv(
     }
     else
     {
-        uintptr_t* rcvr_buf = fx_sync_wait_block_get_attr(wb);
-        *rcvr_buf = msgq->buf[msgq->tail];
-        msgq->tail = (msgq->tail + 1) % msgq->items_max;
+        _fx_msgq_deliver_msg(msgq, wb, msgq->buf[msgq->tail]);
+        msgq->tail = _fx_msgq_next(msgq, msgq->tail);
         --msgq->items;
         
         //
@@ -204,6 +276,8 @@ fx_msgq_test_and_wait_recv(
 //! enough to hold (items_max * sizeof(uintptr_t)) bytes.
 //! @param [in] items_max Maximum item count that may be stored in the queue.
 //! @param [in] policy Waiter notification policy (FIFO or PRIO).
+//! @param [in] ext_attr Receivers use fx_msgq_recv_attr_t as wait attribute 
+//! if true, pointer to message buffer otherwise.
 //! @return FX_STATUS_OK in case of success, error code otherwise.
 //! @sa fx_msgq_deinit
 //!
@@ -212,7 +286,8 @@ fx_msgq_core_init(
     fx_msgq_t* msgq, 
     uintptr_t* buf, 
      unsigned int items_max, 
-     fx_sync_policy_t policy)
+     fx_sync_policy_t policy,
+     bool ext_attr)
 {
     fx_spl_spinlock_init(&msgq->lock);
     fx_rtp_init(&msgq->rtp, FX_MSGQ_MAGIC);
@@ -230,6 +305,8 @@ fx_msgq_core_init(
     msgq->items_max = items_max;
     msgq->policy = policy;
     msgq->items = msgq->head = msgq->tail = 0;
+    msgq->dropped = 0;
+    msgq->ext_attr = ext_attr;
     trace_queue_init(&msgq->trace_handle, items_max);
     return FX_STATUS_OK;
 }
@@ -275,25 +352,126 @@ fx_msgq_core_flush(fx_msgq_t* msgq)
     fx_sync_waitable_lock(&msgq->send_wtbl);
 
     msgq->head = msgq->tail = msgq->items = 0;
+    msgq->dropped = 0;
+    _fx_msgq_accept_senders(msgq);
+    fx_sync_waitable_unlock(&msgq->send_wtbl);
+    fx_sched_unlock(prev);
+    return FX_STATUS_OK;
+}
+
+//!
+//! Sends message into back of the queue without waiting. If the queue is 
+//! full, the oldest message is discarded in order to free the slot and 
+//! counted as dropped for the receiver of the next message.
+//! @param [in] msgq Message queue to send to.
+//! @param [in] msg Message to be sent.
+//! @return true if the oldest message has been discarded, false otherwise.
+//! @remark SPL <= DISPATCH.
+//!
+bool
+fx_msgq_core_overwrite(fx_msgq_t* msgq, uintptr_t msg)
+{
+    bool discarded = false;
+    fx_sched_state_t prev;
+    fx_sched_lock(&prev);
+    fx_sync_waitable_lock(&msgq->send_wtbl);
+
+    if (_fx_sync_waitable_nonempty(&msgq->recv_wtbl))
+    {
+        _fx_msgq_forward_msg(msgq, &msg);
+    }
+    else
+    {
+        if (msgq->items == msgq->items_max)
+        {
+            msgq->tail = _fx_msgq_next(msgq, msgq->tail);
+            --msgq->items;
+            ++msgq->dropped;
+            discarded = true;
+        }
+
+        _fx_msgq_put_msg(msgq, &msg, true);
+        ++msgq->items;
+        trace_queue_send(&msgq->trace_handle, msgq->items);
+    }
+
+    fx_sync_waitable_unlock(&msgq->send_wtbl);
+    fx_sched_unlock(prev);
+    return discarded;
+}
+
+//!
+//! Sends batch of messages into back of the queue without waiting. 
+//! If there are blocked receivers, leading messages of the batch are given 
+//! directly to them (one message per receiver), the rest of the batch is 
+//! copied into the queue until it becomes full. All messages are moved in 
+//! single critical section.
+//! @param [in] msgq Message queue to send to.
+//! @param [in] buf Messages to be sent.
+//! @param [in] n Number of messages in the buffer.
+//! @return Number of messages sent.
+//! @remark SPL = LOW.
+//!
+unsigned int
+fx_msgq_core_send_n(fx_msgq_t* msgq, const uintptr_t* buf, unsigned int n)
+{
+    unsigned int sent = 0;
+    fx_sched_state_t prev;
+    fx_sched_lock(&prev);
+    fx_sync_waitable_lock(&msgq->send_wtbl);
 
     //
-    // Waitable lock is released in notify function after notification of 
-    // each waiter, so, queue state should be examined after each waiter is 
-    // released.
+    // Every blocked receiver should be satisfied before messages are queued, 
+    // since receivers are woken only by incoming messages and those remaining 
+    // blocked would never see messages left in the queue.
     //
-    while ( msgq->items < msgq->items_max && 
-            _fx_sync_waitable_nonempty(&msgq->send_wtbl))
+    while (sent < n && _fx_sync_waitable_nonempty(&msgq->recv_wtbl))
     {
-        fx_sync_wait_block_t* sndr = _fx_sync_wait_block_get(
-            &msgq->send_wtbl, 
-            msgq->policy
-        );
-        fx_msgq_wait_attr_t* attr = fx_sync_wait_block_get_attr(sndr);
-        _fx_msgq_put_msg(msgq, attr->buf, attr->to_back);
+        _fx_msgq_forward_msg(msgq, &buf[sent++]);
+    }
+
+    while (sent < n && msgq->items < msgq->items_max)
+    {
+        _fx_msgq_put_msg(msgq, &buf[sent++], true);
         ++msgq->items;
-        _fx_sync_wait_notify(&msgq->send_wtbl, FX_WAIT_SATISFIED, sndr);
+        trace_queue_send(&msgq->trace_handle, msgq->items);
     }
+
     fx_sync_waitable_unlock(&msgq->send_wtbl);
     fx_sched_unlock(prev);
-    return FX_STATUS_OK;
+    return sent;
+}
+
+//!
+//! Receives batch of messages from the queue without waiting. 
+//! Slots freed by the receiver are filled by blocked senders (if any). All 
+//! messages are moved in single critical section. Number of dropped messages 
+//! is not reported by batch receive.
+//! @param [in] msgq Message queue to receive from.
+//! @param [out] buf Buffer to be filled with messages.
+//! @param [in] n Buffer size in messages.
+//! @return Number of messages received.
+//! @remark SPL = LOW.
+//!
+unsigned int
+fx_msgq_core_receive_n(fx_msgq_t* msgq, uintptr_t* buf, unsigned int n)
+{
+    unsigned int received = 0;
+    fx_sched_state_t prev;
+    fx_sched_lock(&prev);
+    fx_sync_waitable_lock(&msgq->recv_wtbl);
+
+    while (received < n && msgq->items != 0)
+    {
+        buf[received++] = msgq->buf[msgq->tail];
+        msgq->tail = _fx_msgq_next(msgq, msgq->tail);
+        --msgq->items;
+        msgq->dropped = 0;
+        trace_queue_receive(&msgq->trace_handle, msgq->items);
+    }
+
+    _fx_msgq_accept_senders(msgq);
+    fx_sync_waitable_unlock(&msgq->recv_wtbl);
+    fx_sched_unlock(prev);
+    return received;
 }
@@ -41,10 +41,24 @@
 typedef struct
 {
     bool to_back;
-    uintptr_t* buf;
+    const uintptr_t* buf;
 }
 fx_msgq_wait_attr_t;
 
+//
+// Receiver attributes object. It is used as receive wait attribute by queues
+// initialized with extended attributes, otherwise the attribute is pointer to 
+// message buffer. Dropped is optional location for number of messages 
+// discarded by overwrite send since the previous message was taken from the 
+// queue.
+//
+typedef struct
+{
+    uintptr_t* buf;
+    uint32_t* dropped;
+}
+fx_msgq_recv_attr_t;
+
 //!
 //! Message queue object. 
 //! Queue contains two waitable object for senders and receivers.
@@ -61,6 +75,8 @@ typedef struct
     unsigned int tail;
     fx_rtp_t rtp;
     fx_sync_policy_t policy;
+    uint32_t dropped;
+    bool ext_attr;
     trace_queue_handle_t trace_handle;
 } 
 fx_msgq_t;
@@ -72,10 +88,22 @@ int fx_msgq_core_init(
     fx_msgq_t* msgq, 
     uintptr_t* buf, 
     unsigned int sz, 
-    fx_sync_policy_t p
+    fx_sync_policy_t p,
+    bool ext_attr
 );
 int fx_msgq_core_deinit(fx_msgq_t* msgq);
 int fx_msgq_core_flush(fx_msgq_t* msgq);
+bool fx_msgq_core_overwrite(fx_msgq_t* msgq, uintptr_t msg);
+unsigned int fx_msgq_core_send_n(
+    fx_msgq_t* msgq, 
+    const uintptr_t* buf, 
+    unsigned int n
+);
+unsigned int fx_msgq_core_receive_n(
+    fx_msgq_t* msgq, 
+    uintptr_t* buf, 
+    unsigned int n
+);
 bool fx_msgq_test_and_wait_send(
     fx_sync_waitable_t* object, 
     fx_sync_wait_block_t* wb, 
@@ -54,7 +54,7 @@ fx_msgq_init(fx_msgq_t* msgq, uintptr_t* buf, unsigned sz, fx_sync_policy_t p)
         FX_MSGQ_INVALID_BUF
     );
 
-    return fx_msgq_core_init(msgq, buf, sz, p);
+    return fx_msgq_core_init(msgq, buf, sz, p, false);
 }
 
 //!
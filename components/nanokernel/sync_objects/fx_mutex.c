@@ -30,15 +30,31 @@
 
 #include FX_INTERFACE(FX_MUTEX)
 #include FX_INTERFACE(FX_DBG)
+#include FX_INTERFACE(HW_CPU)
 
 FX_METADATA(({ implementation: [FX_MUTEX, V1] }))
 
 #define fx_mutex_is_valid(m) (fx_rtp_check((&((m)->rtp)), FX_MUTEX_MAGIC))
 
+//
+// Owner word contains pointer to owner thread and contention flag in the 
+// least significant bit (thread objects are at least word-aligned). 
+// Uncontended mutex is acquired and released by single CAS without entering
+// the scheduler. Contention flag is set by the kernel when the mutex has 
+// waiters or owner's priority is affected by the mutex. In this case the 
+// mutex is released through the kernel.
+//
+#define FX_MUTEX_CONTENDED ((uintptr_t) 1)
+#define fx_mutex_owner(m) \
+    ((fx_thread_t*) (((uintptr_t) (m)->owner) & ~FX_MUTEX_CONTENDED))
+#define fx_mutex_set_owner(m, t, c) \
+    ((m)->owner = (fx_thread_t*) (((uintptr_t) (t)) | ((c) ? 1 : 0)))
+
 //!
 //! Test and wait function.
 //! If mutex is free this function also performs priority adjust if it is 
-//! enabled for this mutex object.
+//! enabled for this mutex object. If the mutex is busy and priority 
+//! inheritance is enabled, the owner inherits priority of the caller.
 //! @param [in] object Mutex object to be tested.
 //! @param [in] wb Wait block to be inserted into waiters queue if mutex is busy
 //! @param [in] wait Wait option used to test object, if it is nonzero wait will
@@ -55,25 +71,24 @@ fx_mutex_test_and_wait(
 {
     fx_mutex_t* mutex = lang_containing_record(object, fx_mutex_t, waitable);
     fx_thread_t* me = lang_containing_record(wb->waiter, fx_thread_t, waiter);
+    fx_thread_t* const owner = fx_mutex_owner(mutex);
     bool acquired = true;
-    bool apply_ceiling = false;
+    bool apply_pi = false;
+    bool inherit = false;
 
     fx_sync_waitable_lock(object);
 
     do
     {
-        if (!mutex->owner)
+        if (!owner)
         {
-            mutex->owner = me;
-            if (mutex->ceiling_enabled)
-            {
-                apply_ceiling = true;
-            }
+            apply_pi = (mutex->pi.ceiling != NULL);
+            fx_mutex_set_owner(mutex, me, apply_pi);
             trace_mutex_acquired(&mutex->trace_handle, me->trace_handle);
             break;
         }
 
-        if (mutex->owner == me)
+        if (owner == me)
         {
             ++mutex->recursive_locks;
             break;
@@ -82,49 +97,96 @@ fx_mutex_test_and_wait(
         if (wait)
         {            
             _fx_sync_wait_start(object, wb); 
+            fx_mutex_set_owner(mutex, owner, true);
+            inherit = (mutex->pi.waitable != NULL);
             trace_mutex_acquire_block(&mutex->trace_handle);
         }
         acquired = false;
     }
     while (0);
 
-    if (apply_ceiling == true)
+    //
+    // New owner's priority is raised to the ceiling (if enabled). Waiter's 
+    // priority is propagated to the owner and the chain of owners it waits for.
+    // Owner of inheriting mutex is attached to it on first contention.
+    //
+    if (apply_pi == true)
     {      
-        fx_sched_params_copy(
-            fx_thread_as_sched_params(me), 
-            &mutex->owner_params
-        );
+        fx_thread_pi_acquire(&mutex->pi, me);
 
-        if (fx_sched_params_is_preempt(
-                &mutex->ceiling_orig, 
-                fx_thread_as_sched_params(me)))
+        if (mutex->pi.ceiling)
         {
-            fx_thread_lock(me);
-            fx_sched_item_set_params(
-                fx_thread_as_sched_item(me), 
-                &mutex->ceiling_orig
-            );
-            fx_thread_unlock(me);
-
             trace_thread_ceiling(
                 fx_thread_as_trace_handle(me), 
-                fx_sched_params_as_number(&mutex->owner_params),
+                fx_sched_params_as_number(&me->base_params),
                 fx_sched_params_as_number(&mutex->ceiling_orig)
             );
         }
     }
 
+    if (inherit == true)
+    {
+        if (mutex->pi.owner == NULL)
+        {
+            fx_thread_pi_acquire(&mutex->pi, owner);
+        }
+
+        fx_thread_pi_block(me, &mutex->pi);
+    }
+
     fx_sync_waitable_unlock(object);
     return acquired;
 }
 
+//
+// Wait completion. If the wait is not satisfied (due to timeout or 
+// cancellation) the owner of the mutex may lose priority inherited from the 
+// caller. The mutex object is not accessed since it may be deleted.
+//
+static int
+fx_mutex_wait_complete(int error)
+{
+    fx_thread_t* const me = fx_thread_self();
+
+    if (error != FX_THREAD_OK && me->pi_blocked_on)
+    {
+        fx_sched_state_t prev;
+        fx_sched_lock(&prev);
+        fx_thread_pi_unblock(me);
+        fx_sched_unlock(prev);
+    }
+
+    return error;
+}
+
+//
+// Tries to acquire free mutex without entering the scheduler. Ceiling mutexes
+// always use the kernel path since owner's priority has to be changed.
+//
+static inline bool
+fx_mutex_try_fast(fx_mutex_t* mutex)
+{
+    fx_thread_t* const me = fx_thread_self();
+
+    if (mutex->pi.ceiling == NULL && 
+        hw_cpu_atomic_cas_ptr(&mutex->owner, NULL, me) == NULL)
+    {
+        trace_mutex_acquired(&mutex->trace_handle, me->trace_handle);
+        return true;
+    }
+
+    return false;
+}
+
 //!
 //! Mutex initialization.
 //! @param [in,out] mutex Mutex object to be initialized.
 //! @param [in] priority Scheduling priority of the mutex for ceiling. 
 //! The priority will be applied to thread that owns this mutex (while mutex 
 //! is acquired). If this parameter is FX_MUTEX_CEILING_DISABLED then ceiling is
-//! disabled for the mutex.
+//! disabled for the mutex. If this parameter is FX_MUTEX_PRIO_INHERIT then 
+//! the owner inherits priority of the most prioritized waiter, inheritance is
+//! transitive through chains of owners blocked on inheriting mutexes.
 //! @param [in] policy Default policy of waiter releasing for this mutex.
 //! @warning If the ceiling is enabled, be sure that ceiliing priority is equal 
 //! (or greater than) to priority of the most prioritized thread, that may own 
@@ -141,6 +203,7 @@ fx_mutex_init(
     lang_param_assert(mutex != NULL, FX_MUTEX_INVALID_PTR);
     lang_param_assert(
         priority == FX_MUTEX_CEILING_DISABLED || 
+            priority == FX_MUTEX_PRIO_INHERIT ||
             priority < FX_SCHED_ALG_PRIO_NUM - 1, 
         FX_MUTEX_INVALID_PRIORITY
     );
@@ -157,19 +220,21 @@ fx_mutex_init(
     mutex->owner = NULL;
     fx_rtp_init(&mutex->rtp, FX_MUTEX_MAGIC);
 
-    if (priority != FX_MUTEX_CEILING_DISABLED)
+    if (priority == FX_MUTEX_PRIO_INHERIT)
+    {
+        mutex->pi_enabled = true;
+        fx_thread_pi_init(&mutex->pi, &mutex->waitable, NULL);
+    }
+    else if (priority != FX_MUTEX_CEILING_DISABLED)
     {
-        mutex->ceiling_enabled = true; 
+        mutex->pi_enabled = true; 
         fx_sched_params_init_prio(&mutex->ceiling_orig, priority);
-        fx_sched_params_init(
-            &mutex->owner_params, 
-            FX_SCHED_PARAMS_INIT_DEFAULT, 
-            NULL
-        );
+        fx_thread_pi_init(&mutex->pi, NULL, &mutex->ceiling_orig);
     }
     else
     {
-        mutex->ceiling_enabled = false;
+        mutex->pi_enabled = false;
+        fx_thread_pi_init(&mutex->pi, NULL, NULL);
     }
 
     trace_mutex_init(&mutex->trace_handle);
@@ -192,20 +257,38 @@ fx_mutex_deinit(fx_mutex_t* mutex)
     fx_sched_lock(&prev);
     fx_rtp_deinit(&mutex->rtp);
     fx_sync_waitable_lock(&mutex->waitable);
+
+    //
+    // Waiters are no longer blocked on the mutex, so, they must not access it
+    // when the wait is completed.
+    //
+    if (mutex->pi_enabled)
+    {
+        rtl_queue_t* const head = fx_sync_waitable_as_queue(&mutex->waitable);
+        rtl_queue_t* n = NULL;
+
+        for (n = rtl_queue_first(head); n != head; n = rtl_queue_next(n))
+        {
+            fx_sync_wait_block_t* const wb = fx_sync_queue_item_as_wb(n);
+            fx_thread_t* const waiter = lang_containing_record(
+                wb->waiter, 
+                fx_thread_t, 
+                waiter
+            );
+            waiter->pi_blocked_on = NULL;
+        }
+    }
+
     _fx_sync_wait_notify(&mutex->waitable, FX_WAIT_DELETED, NULL);
     fx_sync_waitable_unlock(&mutex->waitable);
 
     //
-    // If mutex is not free and ceiling enabled - perform un-ceiling.
+    // If mutex is not free and ceiling or inheritance is enabled - restore 
+    // owner's priority.
     //
-    if (mutex->owner != NULL && mutex->ceiling_enabled)
+    if (fx_mutex_owner(mutex) != NULL && mutex->pi_enabled)
     {
-        fx_thread_lock(mutex->owner);
-        fx_sched_item_set_params(
-            fx_thread_as_sched_item(mutex->owner), 
-            &mutex->owner_params
-        );
-        fx_thread_unlock(mutex->owner);
+        fx_thread_pi_release(&mutex->pi);
     }
     fx_sched_unlock(prev);
     trace_mutex_deinit(&mutex->trace_handle);
@@ -226,7 +309,15 @@ fx_mutex_acquire(fx_mutex_t* mutex, fx_event_t* abort_event)
     lang_param_assert(fx_mutex_is_valid(mutex), FX_MUTEX_INVALID_OBJ);
 
     fx_dbg_assert(mutex->recursive_locks < UINT_FAST16_MAX);
-    return fx_thread_wait_object(&mutex->waitable, NULL, abort_event);
+
+    if (fx_mutex_try_fast(mutex))
+    {
+        return FX_MUTEX_OK;
+    }
+
+    return fx_mutex_wait_complete(
+        fx_thread_wait_object(&mutex->waitable, NULL, abort_event)
+    );
 }
 
 //!
@@ -243,7 +334,15 @@ fx_mutex_timedacquire(fx_mutex_t* mutex, uint32_t timeout)
     lang_param_assert(fx_mutex_is_valid(mutex), FX_MUTEX_INVALID_OBJ);
 
     fx_dbg_assert(mutex->recursive_locks < UINT_FAST16_MAX);
-    return fx_thread_timedwait_object(&mutex->waitable, NULL, timeout);
+
+    if (fx_mutex_try_fast(mutex))
+    {
+        return FX_MUTEX_OK;
+    }
+
+    return fx_mutex_wait_complete(
+        fx_thread_timedwait_object(&mutex->waitable, NULL, timeout)
+    );
 }
 
 //!
@@ -267,30 +366,32 @@ fx_mutex_release_with_policy(fx_mutex_t* mutex, fx_sync_policy_t policy)
     // will be returned. 
     //
     lang_param_assert(mutex != NULL, FX_MUTEX_INVALID_PTR);
-    lang_param_assert(mutex->owner == me, FX_MUTEX_WRONG_OWNER);
+    lang_param_assert(fx_mutex_owner(mutex) == me, FX_MUTEX_WRONG_OWNER);
     lang_param_assert(fx_mutex_is_valid(mutex), FX_MUTEX_INVALID_OBJ);
     lang_param_assert(policy < FX_SYNC_POLICY_MAX, FX_MUTEX_UNSUPPORTED_POLICY);
 
+    //
+    // Uncontended mutex is released without entering the scheduler. CAS fails
+    // if the kernel has set contention flag since the mutex was acquired.
+    //
+    if (mutex->recursive_locks == 0 && 
+        hw_cpu_atomic_cas_ptr(&mutex->owner, me, NULL) == me)
+    {
+        trace_mutex_released(&mutex->trace_handle, NULL);
+        return FX_MUTEX_OK;
+    }
+
     fx_sched_lock(&prev);
     fx_sync_waitable_lock(&mutex->waitable);
 
     if (mutex->recursive_locks == 0)
     {
-        fx_sched_params_t sched_params;
-
-        //
-        // Save original scheduling parameters from mutex to local storage. 
-        // If mutex has waiter these paramters will be overwritten by parameters 
-        // of new owner. After ceiling has performed restore original scheduling
-        // parameters to current thread.
-        //
-        fx_sched_params_copy(&mutex->owner_params, &sched_params);
+        fx_thread_t* new_owner = NULL;
 
         //
-        // If mutex has waiter: get it and perform ceiling. This action must be 
-        // performed inside mutex lock because there is no guarantee that waiter 
-        // won't skip wait by any other reason. In this case ceiling can be
-        // performed incorrectly.
+        // If mutex has waiter: get it and pass ownership to it. This action 
+        // must be performed inside mutex lock because there is no guarantee 
+        // that waiter won't skip wait by any other reason.
         //
         if (_fx_sync_waitable_nonempty(&mutex->waitable))
         {
@@ -300,73 +401,70 @@ fx_mutex_release_with_policy(fx_mutex_t* mutex, fx_sync_policy_t policy)
             );
             fx_sync_waiter_t* waiter = wb->waiter;
 
-            mutex->owner = lang_containing_record(waiter, fx_thread_t, waiter);
+            new_owner = lang_containing_record(waiter, fx_thread_t, waiter);
+            _fx_sync_wait_notify(&mutex->waitable, FX_WAIT_SATISFIED, wb);
+        }
+
+        trace_mutex_released(
+            &mutex->trace_handle, 
+            new_owner ? fx_thread_as_trace_handle(new_owner) : NULL
+        );
 
-            //
-            // If ceiling is enabled copy scheduling parameters of current 
-            // thread to temporary storage and apply ceiling priority to the 
-            // new owner.
-            //
-            if (mutex->ceiling_enabled)
+        //
+        // Restore priority of the thread that released the mutex and apply
+        // ceiling or inherited priority to the new owner. If the mutex was 
+        // not contended and the priority of the caller is not changed by 
+        // anyone else, the scheduler does not perform rescheduling.
+        //
+        if (mutex->pi_enabled)
+        {
+            if (new_owner)
             {
-                fx_sched_params_copy(
-                    fx_thread_as_sched_params(mutex->owner), 
-                    &mutex->owner_params
+                fx_thread_pi_unblock(new_owner);
+            }
+
+            fx_thread_pi_release(&mutex->pi);
+
+            if (mutex->pi.ceiling)
+            {
+                trace_thread_deceiling(
+                    fx_thread_as_trace_handle(me), 
+                    fx_sched_params_as_number(&mutex->ceiling_orig),
+                    fx_sched_params_as_number(fx_thread_as_sched_params(me))
                 );
+            }
 
-                if (fx_sched_params_is_preempt(
-                        &mutex->ceiling_orig, 
-                        fx_thread_as_sched_params(mutex->owner)))
-                {
-                    fx_thread_lock(mutex->owner);
-                    fx_sched_item_set_params(
-                        fx_thread_as_sched_item(mutex->owner), 
-                        &mutex->ceiling_orig
-                    );
-                    fx_thread_unlock(mutex->owner);
+        }
 
+        //
+        // New owner is attached to the mutex if its priority is affected by 
+        // the mutex or there are remaining waiters. Otherwise the mutex 
+        // becomes uncontended and may be released by the fast path.
+        //
+        if (new_owner)
+        {
+            const bool attach = mutex->pi.ceiling != NULL || 
+                _fx_sync_waitable_nonempty(&mutex->waitable);
+
+            fx_mutex_set_owner(mutex, new_owner, attach);
+
+            if (attach && mutex->pi_enabled)
+            {
+                fx_thread_pi_acquire(&mutex->pi, new_owner);
+
+                if (mutex->pi.ceiling)
+                {
                     trace_thread_ceiling(
-                        fx_thread_as_trace_handle(mutex->owner), 
-                        fx_sched_params_as_number(&mutex->owner_params),
+                        fx_thread_as_trace_handle(new_owner), 
+                        fx_sched_params_as_number(&new_owner->base_params),
                         fx_sched_params_as_number(&mutex->ceiling_orig)
                     );
                 }
             }
-
-            _fx_sync_wait_notify(&mutex->waitable, FX_WAIT_SATISFIED, wb);
-            trace_mutex_released(
-                &mutex->trace_handle, 
-                fx_thread_as_trace_handle(mutex->owner)
-            );
         }
         else
         {
             mutex->owner = NULL;
-            trace_mutex_released(&mutex->trace_handle, NULL);
-        }  
-
-        //
-        // Restore scheduling parameters of thread that released the mutex.
-        //
-        if (mutex->ceiling_enabled)
-        {
-            if (!fx_sched_params_is_equal(
-                    &sched_params, 
-                    fx_thread_as_sched_params(me)))
-            {
-                fx_thread_lock(me);
-                fx_sched_item_set_params(
-                    fx_thread_as_sched_item(me), 
-                    &sched_params
-                );
-                fx_thread_unlock(me);
-            }
-
-            trace_thread_deceiling(
-                fx_thread_as_trace_handle(me), 
-                fx_sched_params_as_number(&mutex->ceiling_orig),
-                fx_sched_params_as_number(&sched_params)
-            );
         }
     }
     else
@@ -401,5 +499,83 @@ fx_mutex_get_owner(fx_mutex_t* mutex)
     lang_param_assert(mutex != NULL, NULL);
     lang_param_assert(fx_mutex_is_valid(mutex), NULL);
     
-    return mutex->owner;
+    return fx_mutex_owner(mutex);
+}
+
+//!
+//! Moves waiter of another object into the mutex queue (wait morphing). It is 
+//! used by condition variables in order to avoid waking up threads which 
+//! would immediately block on the mutex. The waiter becomes owner of the mutex
+//! when it is released from the mutex queue.
+//! @param [in,out] mutex Mutex object.
+//! @param [in] from Waitable containing the wait block.
+//! @param [in,out] wb Wait block to be moved.
+//! @return true if the wait block has been moved, false if the mutex is free 
+//! (or owned by the waiter), in this case the waiter should be notified by 
+//! the caller.
+//! @warning Waitable containing the wait block must be locked by the caller.
+//! @remark SPL = SCHED_LEVEL
+//!
+bool
+fx_mutex_requeue(
+    fx_mutex_t* mutex, 
+    fx_sync_waitable_t* from, 
+    fx_sync_wait_block_t* wb)
+{
+    fx_thread_t* me = lang_containing_record(wb->waiter, fx_thread_t, waiter);
+    fx_thread_t* owner = NULL;
+    bool requeued = false;
+
+    if (!fx_mutex_is_valid(mutex))
+    {
+        return false;
+    }
+
+    fx_sync_waitable_lock(&mutex->waitable);
+    owner = fx_mutex_owner(mutex);
+
+    if (owner != NULL && owner != me)
+    {
+        _fx_sync_wait_requeue(from, &mutex->waitable, wb);
+        fx_mutex_set_owner(mutex, owner, true);
+        trace_mutex_acquire_block(&mutex->trace_handle);
+
+        if (mutex->pi.waitable != NULL)
+        {
+            if (mutex->pi.owner == NULL)
+            {
+                fx_thread_pi_acquire(&mutex->pi, owner);
+            }
+
+            fx_thread_pi_block(me, &mutex->pi);
+        }
+
+        requeued = true;
+    }
+
+    fx_sync_waitable_unlock(&mutex->waitable);
+    return requeued;
+}
+
+//!
+//! Completes the wait of the thread moved into the mutex queue. If the wait 
+//! in the mutex queue was cancelled before the mutex is passed to the caller,
+//! the mutex is acquired in usual way.
+//! @param [in,out] mutex Mutex object.
+//! @return FX_MUTEX_OK in case of success, error code otherwise.
+//! @remark SPL = LOW.
+//!
+int
+fx_mutex_requeue_complete(fx_mutex_t* mutex)
+{
+    lang_param_assert(mutex != NULL, FX_MUTEX_INVALID_PTR);
+    lang_param_assert(fx_mutex_is_valid(mutex), FX_MUTEX_INVALID_OBJ);
+
+    if (fx_mutex_owner(mutex) == fx_thread_self())
+    {
+        return FX_MUTEX_OK;
+    }
+
+    fx_mutex_wait_complete(FX_THREAD_WAIT_CANCELLED);
+    return fx_mutex_acquire(mutex, NULL);
 }
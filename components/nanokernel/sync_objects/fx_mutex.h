@@ -59,9 +59,9 @@ typedef struct
     lock_t lock;
     fx_thread_t* volatile owner;
     volatile uint_fast16_t recursive_locks;
-    bool ceiling_enabled;
+    bool pi_enabled;
     fx_sched_params_t ceiling_orig;
-    fx_sched_params_t owner_params;
+    fx_thread_pi_t pi;
     fx_sync_policy_t policy;
     fx_rtp_t rtp;
     trace_mutex_handle_t trace_handle;
@@ -72,6 +72,7 @@ fx_mutex_t;
 #define fx_mutex_lock_counter_get(m) ((m)->recursive_locks)
 #define fx_mutex_lock_counter_set(m, c) ((m)->recursive_locks = (c))
 #define FX_MUTEX_CEILING_DISABLED (~0U)
+#define FX_MUTEX_PRIO_INHERIT (~1U)
 
 int fx_mutex_init(fx_mutex_t* mutex, unsigned int prio, fx_sync_policy_t p);
 int fx_mutex_deinit(fx_mutex_t* mutex);
@@ -80,6 +81,12 @@ int fx_mutex_timedacquire(fx_mutex_t* mutex, uint32_t tout);
 int fx_mutex_release(fx_mutex_t* mutex);
 int fx_mutex_release_with_policy(fx_mutex_t* mutex, fx_sync_policy_t policy);
 fx_thread_t* fx_mutex_get_owner(fx_mutex_t* mutex);
+bool fx_mutex_requeue(
+    fx_mutex_t* mutex, 
+    fx_sync_waitable_t* from, 
+    fx_sync_wait_block_t* wb
+);
+int fx_mutex_requeue_complete(fx_mutex_t* mutex);
 
 FX_METADATA(({ interface: [FX_MUTEX, V1] }))
 
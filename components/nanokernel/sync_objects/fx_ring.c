@@ -0,0 +1,282 @@
+/** 
+  ******************************************************************************
+  *  @file   fx_ring.c
+  *  @brief  Implementation of single-producer single-consumer ring buffer.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(FX_RING)
+#include FX_INTERFACE(FX_DBG)
+#include FX_INTERFACE(HW_CPU)
+
+FX_METADATA(({ implementation: [FX_RING, V1] }))
+
+#define fx_ring_is_valid(r) (fx_rtp_check((&((r)->rtp)), FX_RING_MAGIC))
+
+//!
+//! Test and wait function. The ring is signaled while it is nonempty, message
+//! is not consumed by this function, the consumer gets it after the wait.
+//! @param [in] object Ring object to be tested.
+//! @param [in] wb Wait block to be inserted into queue if the ring is empty.
+//! @param [in] wait Wait option.
+//! @return true in case of object was signaled, false otherwise.
+//! @remark SPL = SCHED_LEVEL
+//!
+static bool 
+fx_ring_test_and_wait(
+    fx_sync_waitable_t* object, 
+    fx_sync_wait_block_t* wb, 
+    const bool wait)
+{
+    fx_ring_t* const ring = lang_containing_record(object, fx_ring_t, waitable);
+    bool nonempty = false;
+
+    fx_sync_waitable_lock(object);
+
+    //
+    // Waiting flag must be visible to the producer before the head index is 
+    // read, so, either the producer sees the flag and requests wakeup, or 
+    // the consumer sees new head and does not block.
+    //
+    ring->waiting = true;
+    hw_cpu_dmb();
+    nonempty = (ring->head != ring->tail);
+
+    if (nonempty || !wait)
+    {
+        ring->waiting = false;
+    }
+    else
+    {
+        _fx_sync_wait_start(object, wb);
+    }
+
+    fx_sync_waitable_unlock(object);
+    return nonempty;
+}
+
+//
+// Deferred part of producer's wakeup request. 
+// @remark SPL = DISPATCH
+//
+static void
+fx_ring_wakeup(fx_dpc_t* dpc, void* arg)
+{
+    fx_ring_t* const ring = (fx_ring_t*) arg;
+    fx_sched_state_t prev;
+
+    fx_sched_lock_from_disp_spl(&prev);
+    fx_sync_waitable_lock(&ring->waitable);
+    ring->waiting = false;
+
+    if (_fx_sync_waitable_nonempty(&ring->waitable))
+    {
+        _fx_sync_wait_notify(&ring->waitable, FX_WAIT_SATISFIED, NULL);
+    }
+
+    fx_sync_waitable_unlock(&ring->waitable);
+    fx_sched_unlock_from_disp_spl(prev);
+}
+
+//
+// Gets message from the ring (consumer side).
+// @return true if message has been received, false if the ring is empty.
+//
+static bool
+fx_ring_get(fx_ring_t* ring, uintptr_t* msg)
+{
+    const unsigned int tail = ring->tail;
+
+    if (ring->head == tail)
+    {
+        return false;
+    }
+
+    //
+    // Message must be read before the slot is released to the producer.
+    //
+    hw_cpu_dmb();
+    *msg = ring->buf[tail & ring->mask];
+    hw_cpu_dmb();
+    ring->tail = tail + 1;
+    return true;
+}
+
+//!
+//! Initializes the ring buffer.
+//! @param [in,out] ring Ring object to be initialized.
+//! @param [in] buf Buffer for messages.
+//! @param [in] sz Buffer size in messages. Must be a power of two.
+//! @return FX_RING_OK in case of success, error code otherwise.
+//!
+int 
+fx_ring_init(fx_ring_t* ring, uintptr_t* buf, unsigned int sz)
+{
+    lang_param_assert(ring != NULL, FX_RING_INVALID_PTR);
+    lang_param_assert(buf != NULL, FX_RING_INVALID_BUF);
+    lang_param_assert(sz != 0 && (sz & (sz - 1)) == 0, FX_RING_INVALID_BUF);
+
+    fx_spl_spinlock_init(&ring->lock);
+    fx_sync_waitable_init(&ring->waitable, &ring->lock, fx_ring_test_and_wait);
+    ring->buf = buf;
+    ring->mask = sz - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->waiting = false;
+    fx_dpc_init(&ring->dpc);
+    fx_dpc_set_importance(&ring->dpc, FX_DPC_IMPORTANCE_HIGH);
+    fx_rtp_init(&ring->rtp, FX_RING_MAGIC);
+    return FX_RING_OK;
+}
+
+//!
+//! Destructor of the ring buffer. Waiting consumer is released with 
+//! appropriate status.
+//! @param [in,out] ring Ring object to be deinitialized.
+//! @return FX_RING_OK in case of success, error code otherwise.
+//!
+int 
+fx_ring_deinit(fx_ring_t* ring)
+{
+    fx_sched_state_t prev;
+    lang_param_assert(ring != NULL, FX_RING_INVALID_PTR);
+    lang_param_assert(fx_ring_is_valid(ring), FX_RING_INVALID_OBJ);
+
+    fx_sched_lock(&prev);
+    fx_rtp_deinit(&ring->rtp);
+    (void) fx_dpc_cancel(&ring->dpc);
+    fx_sync_waitable_lock(&ring->waitable);
+    _fx_sync_wait_notify(&ring->waitable, FX_WAIT_DELETED, NULL);
+    fx_sync_waitable_unlock(&ring->waitable);
+    fx_sched_unlock(prev);
+    return FX_RING_OK;
+}
+
+//!
+//! Puts message into the ring. It is wait-free: message is written into the 
+//! buffer and head index is published, consumer wakeup is requested only if 
+//! the consumer is waiting for the ring to become nonempty.
+//! @param [in] ring Ring object.
+//! @param [in] msg Message to be sent.
+//! @return FX_RING_OK in case of success, FX_RING_FULL if there is no free 
+//! space in the ring.
+//! @remark SPL <= SYNC. Only one producer is allowed at any given moment.
+//!
+int 
+fx_ring_send(fx_ring_t* ring, uintptr_t msg)
+{
+    unsigned int head;
+    lang_param_assert(ring != NULL, FX_RING_INVALID_PTR);
+    lang_param_assert(fx_ring_is_valid(ring), FX_RING_INVALID_OBJ);
+
+    head = ring->head;
+
+    if (head - ring->tail > ring->mask)
+    {
+        return FX_RING_FULL;
+    }
+
+    ring->buf[head & ring->mask] = msg;
+    hw_cpu_dmb();
+    ring->head = head + 1;
+    hw_cpu_dmb();
+
+    if (ring->waiting)
+    {
+        (void) fx_dpc_request(&ring->dpc, fx_ring_wakeup, ring);
+    }
+
+    return FX_RING_OK;
+}
+
+//!
+//! Receives message from the ring. If the ring is empty, calling thread is 
+//! blocked until the producer puts a message or cancel event is set.
+//! @param [in] ring Ring object.
+//! @param [out] msg Message buffer.
+//! @param [in] cancel_event Optional cancel event (can be NULL).
+//! @return Result of wait operation.
+//! @remark SPL = LOW. Only one consumer is allowed at any given moment.
+//!
+int 
+fx_ring_receive(fx_ring_t* ring, uintptr_t* msg, fx_event_t* cancel_event)
+{
+    int error = FX_RING_OK;
+    lang_param_assert(ring != NULL, FX_RING_INVALID_PTR);
+    lang_param_assert(fx_ring_is_valid(ring), FX_RING_INVALID_OBJ);
+    lang_param_assert(msg != NULL, FX_RING_INVALID_BUF);
+
+    while (error == FX_RING_OK && !fx_ring_get(ring, msg))
+    {
+        error = fx_thread_wait_object(&ring->waitable, NULL, cancel_event);
+    }
+
+    return error;
+}
+
+//!
+//! Receives message from the ring with timeout. 
+//! @param [in] ring Ring object.
+//! @param [out] msg Message buffer.
+//! @param [in] tout Timeout (in ticks) or FX_THREAD_INFINITE_TIMEOUT value.
+//! @return Result of wait operation.
+//! @remark SPL = LOW. Only one consumer is allowed at any given moment.
+//!
+int 
+fx_ring_timedreceive(fx_ring_t* ring, uintptr_t* msg, uint32_t tout)
+{
+    int error = FX_RING_OK;
+    lang_param_assert(ring != NULL, FX_RING_INVALID_PTR);
+    lang_param_assert(fx_ring_is_valid(ring), FX_RING_INVALID_OBJ);
+    lang_param_assert(msg != NULL, FX_RING_INVALID_BUF);
+
+    //
+    // The consumer is released only when the ring is nonempty and nobody else
+    // may get messages, so, second iteration always succeeds.
+    //
+    while (error == FX_RING_OK && !fx_ring_get(ring, msg))
+    {
+        error = fx_thread_timedwait_object(&ring->waitable, NULL, tout);
+    }
+
+    return error;
+}
+
+//!
+//! Gets number of messages in the ring.
+//! @param [in] ring Ring object.
+//! @param [out] count Pointer to location where number of messages is stored.
+//! @return FX_RING_OK in case of success, error code otherwise.
+//!
+int 
+fx_ring_get_count(fx_ring_t* ring, unsigned int* count)
+{
+    lang_param_assert(ring != NULL, FX_RING_INVALID_PTR);
+    lang_param_assert(count != NULL, FX_RING_INVALID_PTR);
+    lang_param_assert(fx_ring_is_valid(ring), FX_RING_INVALID_OBJ);
+
+    *count = ring->head - ring->tail;
+    return FX_RING_OK;
+}
@@ -0,0 +1,82 @@
+#ifndef _FX_RING_V1_HEADER_
+#define _FX_RING_V1_HEADER_
+
+/** 
+  ******************************************************************************
+  *  @file   fx_ring.h
+  *  @brief  Single-producer single-consumer ring buffer.
+  *  Producer side is wait-free and may be used from interrupt handlers without
+  *  masking interrupts. Consumer thread is blocked only when the ring is empty.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(LANG_TYPES)
+#include FX_INTERFACE(FX_SYNC)
+#include FX_INTERFACE(FX_THREAD)
+#include FX_INTERFACE(FX_DPC)
+#include FX_INTERFACE(FX_RTP)
+
+enum
+{
+    FX_RING_MAGIC = 0x52494E47, // RING
+    FX_RING_OK = FX_STATUS_OK,
+    FX_RING_INVALID_PTR = FX_THREAD_ERR_MAX,
+    FX_RING_INVALID_OBJ,
+    FX_RING_INVALID_BUF,
+    FX_RING_FULL,
+    FX_RING_ERR_MAX
+};
+
+//!
+//! Ring buffer representation. 
+//! Head index is written by the producer only, tail index is written by the 
+//! consumer only. Indices are free-running, buffer size is a power of two.
+//! Waiting flag is set by the consumer before it tests the ring for emptiness,
+//! the producer requests consumer wakeup only if the flag is set.
+//!
+typedef struct
+{
+    fx_sync_waitable_t waitable;
+    lock_t lock;
+    uintptr_t* buf;
+    unsigned int mask;
+    volatile unsigned int head;
+    volatile unsigned int tail;
+    volatile bool waiting;
+    fx_dpc_t dpc;
+    fx_rtp_t rtp;
+}
+fx_ring_t;
+
+int fx_ring_init(fx_ring_t* ring, uintptr_t* buf, unsigned int sz);
+int fx_ring_deinit(fx_ring_t* ring);
+int fx_ring_send(fx_ring_t* ring, uintptr_t msg);
+int fx_ring_receive(fx_ring_t* ring, uintptr_t* msg, fx_event_t* cancel_ev);
+int fx_ring_timedreceive(fx_ring_t* ring, uintptr_t* msg, uint32_t tout);
+int fx_ring_get_count(fx_ring_t* ring, unsigned int* count);
+
+FX_METADATA(({ interface: [FX_RING, V1] }))
+
+#endif
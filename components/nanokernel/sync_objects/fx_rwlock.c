@@ -56,9 +56,13 @@ fx_rwlock_test_and_wait_reader(
     fx_sync_waitable_lock(object);
 
     //
-    // If rwlock is not acquired by writer and there are no waiting writers.
+    // If rwlock is not acquired by writer and there are no waiting writers
+    // (unless readers are preferred) and no pending upgrade.
     //
-    if (rwlock->owner==NULL && !_fx_sync_waitable_nonempty(&rwlock->wr_wtbl))
+    if (rwlock->owner == NULL && 
+        !_fx_sync_waitable_nonempty(&rwlock->up_wtbl) &&
+        (rwlock->mode == FX_RWLOCK_READER_PREF || 
+            !_fx_sync_waitable_nonempty(&rwlock->wr_wtbl)))
     {
         ++rwlock->readers;
         wait_satisfied = true;
@@ -108,18 +112,107 @@ fx_rwlock_test_and_wait_writer(
     return wait_satisfied;
 }
 
+//
+// Test and wait function for upgrading reader. Reader becomes writer when it 
+// is the only reader, if another upgrade is pending or rwlock is not acquired
+// by readers, wait is completed immediately with "busy" flag set in order to 
+// avoid deadlock.
+// @param [in] object Waitable object to be tested.
+// @param [in] wb Wait block to be inserted into queue if it is nonsignaled.
+// @param [in] wait Wait option.
+// @return true in case of object is signaled, false otherwise. 
+// @remark SPL = SCHED_LEVEL
+//
+static bool
+fx_rwlock_test_and_wait_upgrader(
+    fx_sync_waitable_t* object, 
+    fx_sync_wait_block_t* wb, 
+    const bool wait)
+{
+    fx_thread_t* me = fx_thread_self();
+    fx_rwlock_t* rwlock = lang_containing_record(object, fx_rwlock_t, up_wtbl);
+    bool* const busy = fx_sync_wait_block_get_attr(wb);
+    bool wait_satisfied = true;
+
+    fx_sync_waitable_lock(object);
+
+    if (rwlock->owner != NULL || 
+        rwlock->readers == 0 || 
+        _fx_sync_waitable_nonempty(object))
+    {
+        *busy = true;
+    }
+    else if (rwlock->readers == 1)
+    {
+        rwlock->readers = 0;
+        rwlock->owner = me;
+    }
+    else
+    {
+        if (wait)
+        {
+            _fx_sync_wait_start(object, wb);
+        }
+        wait_satisfied = false;
+    }
+
+    fx_sync_waitable_unlock(object);
+    return wait_satisfied;
+}
+
+//
+// Passes the lock to the waiter from writers or upgrader queue.
+// @warning This function assumes object is already locked by caller.
+//
+static void
+fx_rwlock_release_writer(
+    fx_rwlock_t* rwlock, 
+    fx_sync_waitable_t* wtbl, 
+    fx_sync_policy_t policy)
+{
+    fx_sync_wait_block_t* wb = _fx_sync_wait_block_get(wtbl, policy);
+    fx_sync_waiter_t* waiter = wb->waiter;
+    rwlock->owner = lang_containing_record(waiter, fx_thread_t, waiter);
+    _fx_sync_wait_notify(wtbl, FX_WAIT_SATISFIED, wb);
+}
+
+//
+// Releases all waiting readers at once. Readers are accounted before the
+// notification, so, the queue is traversed only once and each waiter is 
+// removed in constant time.
+// @warning This function assumes object is already locked by caller.
+//
+static void
+fx_rwlock_release_readers(fx_rwlock_t* rwlock)
+{
+    rtl_queue_t* const head = fx_sync_waitable_as_queue(&rwlock->rd_wtbl);
+    rtl_queue_t* n = NULL;
+
+    for (n = rtl_queue_first(head); n != head; n = rtl_queue_next(n))
+    {
+        ++rwlock->readers;
+    }
+
+    _fx_sync_wait_notify(&rwlock->rd_wtbl, FX_WAIT_SATISFIED, NULL);
+}
+
 //!
 //! Rwlock initialization.
 //! @param [in,out] rwlock Rwlock object to be initialized.
 //! @param [in] policy Waiter releasing policy (for both readers and writers).
+//! @param [in] mode Arbitration between readers and writers.
 //! @return FX_RWLOCK_OK in case of success, error code otherwise.
 //! @sa fx_rwlock_deinit
 //!
 int
-fx_rwlock_init(fx_rwlock_t* rwlock, const fx_sync_policy_t policy)
+fx_rwlock_init_ex(
+    fx_rwlock_t* rwlock, 
+    const fx_sync_policy_t policy, 
+    const fx_rwlock_mode_t mode)
 {
     lang_param_assert(rwlock != NULL, FX_RWLOCK_INVALID_PTR);
     lang_param_assert(policy < FX_SYNC_POLICY_MAX,FX_RWLOCK_UNSUPPORTED_POLICY);
+    lang_param_assert(mode < FX_RWLOCK_MODE_MAX, FX_RWLOCK_UNSUPPORTED_MODE);
 
     fx_rtp_init(&rwlock->rtp, FX_RWLOCK_MAGIC);
     fx_spl_spinlock_init(&rwlock->lock);
@@ -133,7 +226,15 @@ fx_rwlock_init(fx_rwlock_t* rwlock, const fx_sync_policy_t policy)
         &rwlock->lock,
         fx_rwlock_test_and_wait_writer
     );
+    fx_sync_waitable_init(
+        &rwlock->up_wtbl,
+        &rwlock->lock,
+        fx_rwlock_test_and_wait_upgrader
+    );
+    rwlock->readers = 0;
+    rwlock->owner = NULL;
     rwlock->policy = policy;
+    rwlock->mode = mode;
     return FX_RWLOCK_OK;
 }
 
@@ -156,6 +257,7 @@ fx_rwlock_deinit(fx_rwlock_t* rwlock)
     fx_sync_waitable_lock(&rwlock->rd_wtbl);
     _fx_sync_wait_notify(&rwlock->rd_wtbl, FX_WAIT_DELETED, NULL);
     _fx_sync_wait_notify(&rwlock->wr_wtbl, FX_WAIT_DELETED, NULL);
+    _fx_sync_wait_notify(&rwlock->up_wtbl, FX_WAIT_DELETED, NULL);
     fx_sync_waitable_unlock(&rwlock->rd_wtbl);
     fx_sched_unlock(prev);
     return FX_RWLOCK_OK;
@@ -164,7 +266,8 @@ fx_rwlock_deinit(fx_rwlock_t* rwlock)
 //!
 //! Unlocking the rwlock.
 //! @param [in,out] rwlock Rwlock object to be unlocked.
-//! @param [in] policy Waiter releasing policy.
+//! @param [in] policy Writers releasing policy. Readers are always released 
+//! all at once.
 //! @return FX_RWLOCK_OK in case of success, error code otherwise.
 //! @sa fx_rwlock_rd_lock
 //! @sa fx_rwlock_wr_lock
@@ -186,38 +289,22 @@ fx_rwlock_unlock_with_policy(fx_rwlock_t* rwlock, fx_sync_policy_t policy)
     //
     if (rwlock->owner == me)
     {
+        rwlock->owner = NULL;
+
         //
-        // Release next writer if writers queue is not empty.
+        // Release next writer if writers are preferred or there are no 
+        // waiting readers. Otherwise read phase is started and all waiting 
+        // readers get the lock.
         //
-        if (_fx_sync_waitable_nonempty(&rwlock->wr_wtbl))
+        if (_fx_sync_waitable_nonempty(&rwlock->rd_wtbl) && 
+            (rwlock->mode != FX_RWLOCK_WRITER_PREF || 
+                !_fx_sync_waitable_nonempty(&rwlock->wr_wtbl)))
         {
-            fx_sync_wait_block_t* wb = _fx_sync_wait_block_get(
-                &rwlock->wr_wtbl, 
-                policy
-            );
-            fx_sync_waiter_t* waiter = wb->waiter;
-            rwlock->owner = lang_containing_record(waiter, fx_thread_t, waiter);
-            _fx_sync_wait_notify(&rwlock->wr_wtbl, FX_WAIT_SATISFIED, wb);
+            fx_rwlock_release_readers(rwlock);
         }
-        else
+        else if (_fx_sync_waitable_nonempty(&rwlock->wr_wtbl))
         {
-            rwlock->owner = NULL;
-
-            //
-            // Release readers until some writer is blocked. Notification 
-            // function releases the spinlock and queue may be changed after 
-            // each iteration.
-            //
-            while ( _fx_sync_waitable_nonempty(&rwlock->rd_wtbl) &&
-                    !_fx_sync_waitable_nonempty(&rwlock->wr_wtbl))
-            {
-                fx_sync_wait_block_t* wb = _fx_sync_wait_block_get(
-                    &rwlock->rd_wtbl, 
-                    policy
-                );
-                ++rwlock->readers;
-                _fx_sync_wait_notify(&rwlock->rd_wtbl, FX_WAIT_SATISFIED, wb);
-            }
+            fx_rwlock_release_writer(rwlock, &rwlock->wr_wtbl, policy);
         }
     }
     //
@@ -230,19 +317,19 @@ fx_rwlock_unlock_with_policy(fx_rwlock_t* rwlock, fx_sync_policy_t policy)
             --rwlock->readers;
 
             //
-            // Notify writer if we are the last reader.
+            // If only upgrading reader remains it becomes writer. Otherwise
+            // notify writer if we are the last reader.
             //
-            if (rwlock->readers == 0 && 
+            if (rwlock->readers == 1 && 
+                _fx_sync_waitable_nonempty(&rwlock->up_wtbl))
+            {
+                rwlock->readers = 0;
+                fx_rwlock_release_writer(rwlock, &rwlock->up_wtbl, policy);
+            }
+            else if (rwlock->readers == 0 && 
                 _fx_sync_waitable_nonempty(&rwlock->wr_wtbl))
             {
-                fx_sync_wait_block_t* wb = _fx_sync_wait_block_get(
-                    &rwlock->wr_wtbl, 
-                    policy
-                );
-                fx_sync_waiter_t* waiter = wb->waiter;
-                rwlock->owner = 
-                    lang_containing_record(waiter, fx_thread_t, waiter);
-                _fx_sync_wait_notify(&rwlock->wr_wtbl, FX_WAIT_SATISFIED, wb);
+                fx_rwlock_release_writer(rwlock, &rwlock->wr_wtbl, policy);
             }
         }
     }
@@ -317,7 +404,7 @@ fx_rwlock_rd_timedlock(fx_rwlock_t* rwlock, uint32_t tout)
 //! blocked readers should be unlocked if rwlock is not blocked by writer and 
 //! there are no writers in the queue. This function is used in wr-lock 
 //! functions in order to release readers, if writer's wait is skipped due to 
-//! some reason.
+//! some reason. Same applies to cancelled upgrade.
 //!
 static void
 fx_rwlock_kick_readers(fx_rwlock_t* rwlock)
@@ -326,15 +413,11 @@ fx_rwlock_kick_readers(fx_rwlock_t* rwlock)
     fx_sched_lock(&prev);
     fx_sync_waitable_lock(&rwlock->rd_wtbl);
 
-    while (_fx_sync_waitable_nonempty(&rwlock->rd_wtbl) &&
-              !_fx_sync_waitable_nonempty(&rwlock->wr_wtbl))
+    if (rwlock->owner == NULL && 
+        !_fx_sync_waitable_nonempty(&rwlock->wr_wtbl) &&
+        !_fx_sync_waitable_nonempty(&rwlock->up_wtbl))
     {
-        fx_sync_wait_block_t* wb = _fx_sync_wait_block_get(
-            &rwlock->rd_wtbl, 
-            rwlock->policy
-        );
-        ++rwlock->readers;
-        _fx_sync_wait_notify(&rwlock->rd_wtbl, FX_WAIT_SATISFIED, wb);
+        fx_rwlock_release_readers(rwlock);
     }
 
     fx_sync_waitable_unlock(&rwlock->rd_wtbl);
@@ -401,3 +484,100 @@ fx_rwlock_wr_timedlock(fx_rwlock_t* rwlock, uint32_t tout)
     }
     return res;
 }
+
+//!
+//! Upgrading read lock to write lock. Caller must hold read lock, it becomes
+//! writer when all other readers release the lock. New readers are blocked 
+//! while upgrade is pending. Only one upgrade may be pending at a time.
+//! @param [in] rwlock Rwlock object.
+//! @param [in] cancel_event Cancel event (wait will be aborted if this event 
+//! become signaled during waiting, may be NULL).
+//! @return Wait status or FX_RWLOCK_BUSY if another upgrade is pending. If 
+//! upgrade fails the caller still holds read lock.
+//! @sa fx_rwlock_timedupgrade
+//! @sa fx_rwlock_downgrade
+//!
+int
+fx_rwlock_upgrade(fx_rwlock_t* rwlock, fx_event_t* cancel_event)
+{
+    int res = FX_STATUS_OK;
+    bool busy = false;
+    lang_param_assert(rwlock != NULL, FX_RWLOCK_INVALID_PTR);
+    lang_param_assert(fx_rwlock_is_valid(rwlock), FX_RWLOCK_INVALID_OBJ);
+
+    res = fx_thread_wait_object(&rwlock->up_wtbl, &busy, cancel_event);
+    if (res != FX_STATUS_OK)
+    {
+        fx_rwlock_kick_readers(rwlock);
+    }
+    return busy ? FX_RWLOCK_BUSY : res;
+}
+
+//!
+//! Upgrading read lock to write lock with timeout.
+//! @param [in] rwlock Rwlock object.
+//! @param [in] tout Timeout value (or FX_THREAD_INFINITE_TIMEOUT).
+//! @return Wait status or FX_RWLOCK_BUSY if another upgrade is pending. If 
+//! upgrade fails the caller still holds read lock.
+//! @sa fx_rwlock_upgrade
+//! @sa fx_rwlock_downgrade
+//!
+int
+fx_rwlock_timedupgrade(fx_rwlock_t* rwlock, uint32_t tout)
+{
+    int res = FX_STATUS_OK;
+    bool busy = false;
+    lang_param_assert(rwlock != NULL, FX_RWLOCK_INVALID_PTR);
+    lang_param_assert(fx_rwlock_is_valid(rwlock), FX_RWLOCK_INVALID_OBJ);
+    lang_param_assert(
+        tout < FX_TIMER_MAX_RELATIVE_TIMEOUT, 
+        FX_RWLOCK_INVALID_TIMEOUT
+    );
+
+    res = fx_thread_timedwait_object(&rwlock->up_wtbl, &busy, tout);
+    if (res != FX_STATUS_OK)
+    {
+        fx_rwlock_kick_readers(rwlock);
+    }
+    return busy ? FX_RWLOCK_BUSY : res;
+}
+
+//!
+//! Downgrading write lock to read lock. Caller becomes reader without 
+//! releasing the lock, waiting readers also get the lock unless writers are
+//! preferred and there are waiting writers.
+//! @param [in] rwlock Rwlock object.
+//! @return FX_RWLOCK_OK in case of success, error code otherwise.
+//! @sa fx_rwlock_upgrade
+//!
+int
+fx_rwlock_downgrade(fx_rwlock_t* rwlock)
+{
+    fx_sched_state_t prev;
+    int error = FX_RWLOCK_OK;
+    lang_param_assert(rwlock != NULL, FX_RWLOCK_INVALID_PTR);
+    lang_param_assert(fx_rwlock_is_valid(rwlock), FX_RWLOCK_INVALID_OBJ);
+
+    fx_sched_lock(&prev);
+    fx_sync_waitable_lock(&rwlock->rd_wtbl);
+
+    if (rwlock->owner == fx_thread_self())
+    {
+        rwlock->owner = NULL;
+        rwlock->readers = 1;
+
+        if (rwlock->mode != FX_RWLOCK_WRITER_PREF || 
+            !_fx_sync_waitable_nonempty(&rwlock->wr_wtbl))
+        {
+            fx_rwlock_release_readers(rwlock);
+        }
+    }
+    else
+    {
+        error = FX_RWLOCK_WRONG_OWNER;
+    }
+
+    fx_sync_waitable_unlock(&rwlock->rd_wtbl);
+    fx_sched_unlock(prev);
+    return error;
+}
@@ -42,26 +42,58 @@ enum
     FX_RWLOCK_INVALID_OBJ,
     FX_RWLOCK_UNSUPPORTED_POLICY,
     FX_RWLOCK_INVALID_TIMEOUT,
+    FX_RWLOCK_UNSUPPORTED_MODE,
+    FX_RWLOCK_WRONG_OWNER,
+    FX_RWLOCK_BUSY,
     FX_RWLOCK_ERR_MAX
 };
 
+//!
+//! Arbitration between readers and writers.
+//! Writer preference: new readers are blocked while there are waiting writers,
+//! unlocking writer passes the lock to the next writer if any.
+//! Reader preference: readers are blocked only by the lock owned by writer, 
+//! unlocking writer releases waiting readers first.
+//! Phase-fair: new readers are blocked while there are waiting writers, 
+//! unlocking writer releases waiting readers first, so, read and write phases
+//! alternate and neither readers nor writers may starve.
+//!
+typedef enum
+{
+    FX_RWLOCK_WRITER_PREF = 0,
+    FX_RWLOCK_READER_PREF = 1,
+    FX_RWLOCK_PHASE_FAIR = 2,
+    FX_RWLOCK_MODE_MAX
+}
+fx_rwlock_mode_t;
+
 //!
 //! RW-lock object. 
-//! There are two wait queues used, one for readers and one for writers.
+//! There are three wait queues used: for readers, for writers and for reader 
+//! waiting for upgrade (only one upgrade may be pending).
 //!
 typedef struct
 {
     fx_sync_waitable_t rd_wtbl;
     fx_sync_waitable_t wr_wtbl;
+    fx_sync_waitable_t up_wtbl;
     lock_t lock;
     fx_rtp_t rtp;
     unsigned int readers;
     fx_thread_t* owner;
     fx_sync_policy_t policy;
+    fx_rwlock_mode_t mode;
 } 
 fx_rwlock_t;
 
-int fx_rwlock_init(fx_rwlock_t* rw, fx_sync_policy_t policy);
+#define fx_rwlock_init(rw, policy) \
+    fx_rwlock_init_ex(rw, policy, FX_RWLOCK_WRITER_PREF)
+
+int fx_rwlock_init_ex(
+    fx_rwlock_t* rw, 
+    fx_sync_policy_t policy, 
+    fx_rwlock_mode_t mode
+);
 int fx_rwlock_deinit(fx_rwlock_t* rw);
 int fx_rwlock_rd_timedlock(fx_rwlock_t* rw, uint32_t tout);
 int fx_rwlock_wr_timedlock(fx_rwlock_t* rw, uint32_t tout);
@@ -69,6 +101,9 @@ int fx_rwlock_rd_lock(fx_rwlock_t* rw, fx_event_t* cancel_event);
 int fx_rwlock_wr_lock(fx_rwlock_t* rw, fx_event_t* cancel_event);
 int fx_rwlock_unlock(fx_rwlock_t* rw);
 int fx_rwlock_unlock_with_policy(fx_rwlock_t* rw, fx_sync_policy_t policy);
+int fx_rwlock_upgrade(fx_rwlock_t* rw, fx_event_t* cancel_event);
+int fx_rwlock_timedupgrade(fx_rwlock_t* rw, uint32_t tout);
+int fx_rwlock_downgrade(fx_rwlock_t* rw);
 
 FX_METADATA(({ interface: [FX_RWLOCK, V1] }))
 
@@ -35,6 +35,31 @@ FX_METADATA(({ implementation: [FX_SEM, V1] }))
 
 #define fx_sem_is_valid(sem) (fx_rtp_check((&((sem)->rtp)), FX_SEM_MAGIC))
 
+//
+// Semaphore counter is changed by CAS when it is possible to do it without 
+// the scheduler. Waiters may exist only while the counter is zero, so, nonzero
+// counter may be decremented or incremented (if it is below the maximum)
+// without entering the kernel. Kernel modifies the counter at SCHED_LEVEL, 
+// interrupted CAS retries with new value.
+//
+static inline bool
+fx_sem_try_fast(fx_sem_t* sem, bool post)
+{
+    unsigned int value;
+
+    while ((value = sem->semaphore) != 0 && (!post || value < sem->max_count))
+    {
+        const unsigned int new_value = post ? value + 1 : value - 1;
+
+        if (hw_cpu_atomic_cas(&sem->semaphore, value, new_value) == value)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 //!
 //! Test and wait function.
 //! @param [in] object Semaphore object to be tested.
@@ -180,6 +205,12 @@ fx_sem_post_with_policy(fx_sem_t* sem, fx_sync_policy_t p)
     lang_param_assert(sem != NULL, FX_SEM_INVALID_PTR);
     lang_param_assert(fx_sem_is_valid(sem), FX_SEM_INVALID_OBJ);
     lang_param_assert(p < FX_SYNC_POLICY_MAX, FX_SEM_UNSUPPORTED_POLICY);
+
+    if (fx_sem_try_fast(sem, true))
+    {
+        trace_sem_post(&sem->trace_handle, sem->semaphore);
+        return FX_SEM_OK;
+    }
         
     fx_sched_lock(&prev);
     fx_sync_waitable_lock(&sem->waitable);
@@ -227,6 +258,12 @@ fx_sem_wait(fx_sem_t* sem, fx_event_t* abort_event)
     lang_param_assert(sem != NULL, FX_SEM_INVALID_PTR);
     lang_param_assert(fx_sem_is_valid(sem), FX_SEM_INVALID_OBJ);
 
+    if (fx_sem_try_fast(sem, false))
+    {
+        trace_sem_wait_ok(&sem->trace_handle, sem->semaphore);
+        return FX_SEM_OK;
+    }
+
     return fx_thread_wait_object(&sem->waitable, NULL, abort_event);
 }
 
@@ -243,6 +280,12 @@ fx_sem_timedwait(fx_sem_t* sem, uint32_t timeout)
     lang_param_assert(sem != NULL, FX_SEM_INVALID_PTR);
     lang_param_assert(fx_sem_is_valid(sem), FX_SEM_INVALID_OBJ);
 
+    if (fx_sem_try_fast(sem, false))
+    {
+        trace_sem_wait_ok(&sem->trace_handle, sem->semaphore);
+        return FX_SEM_OK;
+    }
+
     return fx_thread_timedwait_object(&sem->waitable, NULL, timeout);
 }
 
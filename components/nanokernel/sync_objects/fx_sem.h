@@ -54,7 +54,7 @@ typedef struct
 {
     fx_sync_waitable_t waitable;
     lock_t lock;
-    unsigned int semaphore;
+    volatile unsigned int semaphore;
     unsigned int max_count;
     fx_sync_policy_t policy;
     fx_rtp_t rtp;
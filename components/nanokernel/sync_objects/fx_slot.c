@@ -0,0 +1,234 @@
+/** 
+  ******************************************************************************
+  *  @file   fx_slot.c
+  *  @brief  Implementation of single-slot mailbox.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(FX_SLOT)
+
+FX_METADATA(({ implementation: [FX_SLOT, V1] }))
+
+#define fx_slot_is_valid(s) (fx_rtp_check((&((s)->rtp)), FX_SLOT_MAGIC))
+
+//
+// Attributes object used to get value and its sequence number from the test
+// and wait function or from the sender. Sequence pointer may be NULL.
+//
+typedef struct
+{
+    uintptr_t* msg;
+    uint32_t* seq;
+}
+fx_slot_wait_attr_t;
+
+//
+// Copies value into receiver's buffer.
+//
+static void
+fx_slot_deliver(fx_slot_wait_attr_t* attr, uintptr_t msg, uint32_t seq)
+{
+    *attr->msg = msg;
+
+    if (attr->seq != NULL)
+    {
+        *attr->seq = seq;
+    }
+}
+
+//!
+//! Test and wait function. Slot is signaled while it contains a value, the
+//! value is received by the caller and the slot becomes empty.
+//! @param [in] object Slot object to be tested.
+//! @param [in] wb Wait block to be inserted into queue if the slot is empty.
+//! @param [in] wait Wait option.
+//! @return true in case of object was signaled, false otherwise.
+//! @remark SPL = SCHED_LEVEL
+//!
+static bool
+fx_slot_test_and_wait(
+    fx_sync_waitable_t* object,
+    fx_sync_wait_block_t* wb,
+    const bool wait)
+{
+    fx_slot_t* const slot = lang_containing_record(object, fx_slot_t, waitable);
+    bool full = false;
+
+    fx_sync_waitable_lock(object);
+    full = slot->full;
+
+    if (full)
+    {
+        fx_slot_deliver(fx_sync_wait_block_get_attr(wb), slot->msg, slot->seq);
+        slot->full = false;
+    }
+    else if (wait)
+    {
+        _fx_sync_wait_start(object, wb);
+    }
+
+    fx_sync_waitable_unlock(object);
+    return full;
+}
+
+//!
+//! Initializes the slot. Slot is initially empty.
+//! @param [in,out] slot Slot object to be initialized.
+//! @param [in] p Waiter notification policy.
+//! @return FX_SLOT_OK in case of success, error code otherwise.
+//!
+int
+fx_slot_init(fx_slot_t* slot, fx_sync_policy_t p)
+{
+    lang_param_assert(slot != NULL, FX_SLOT_INVALID_PTR);
+    lang_param_assert(p < FX_SYNC_POLICY_MAX, FX_SLOT_UNSUPPORTED_POLICY);
+
+    fx_spl_spinlock_init(&slot->lock);
+    fx_sync_waitable_init(&slot->waitable, &slot->lock, fx_slot_test_and_wait);
+    slot->msg = 0;
+    slot->seq = 0;
+    slot->full = false;
+    slot->policy = p;
+    fx_rtp_init(&slot->rtp, FX_SLOT_MAGIC);
+    return FX_SLOT_OK;
+}
+
+//!
+//! Destructor of the slot. Waiters are released with appropriate status.
+//! @param [in,out] slot Slot object to be deinitialized.
+//! @return FX_SLOT_OK in case of success, error code otherwise.
+//!
+int
+fx_slot_deinit(fx_slot_t* slot)
+{
+    fx_sched_state_t prev;
+    lang_param_assert(slot != NULL, FX_SLOT_INVALID_PTR);
+    lang_param_assert(fx_slot_is_valid(slot), FX_SLOT_INVALID_OBJ);
+
+    fx_sched_lock(&prev);
+    fx_rtp_deinit(&slot->rtp);
+    fx_sync_waitable_lock(&slot->waitable);
+    _fx_sync_wait_notify(&slot->waitable, FX_WAIT_DELETED, NULL);
+    fx_sync_waitable_unlock(&slot->waitable);
+    fx_sched_unlock(prev);
+    return FX_SLOT_OK;
+}
+
+//!
+//! Posts new value into the slot. If there are waiting receivers, the value
+//! is given directly to one of them (according to notification policy),
+//! otherwise it replaces the value stored in the slot. This function never
+//! blocks and takes constant time, so, it may be used by interrupt handlers in
+//! unified SPL scheme, in segmented scheme ISRs should call it from DPC.
+//! @param [in,out] slot Slot object.
+//! @param [in] msg Value to be posted.
+//! @return FX_SLOT_OK in case of success, error code otherwise.
+//! @remark SPL <= DISPATCH.
+//!
+int
+fx_slot_post(fx_slot_t* slot, uintptr_t msg)
+{
+    fx_sched_state_t prev;
+    lang_param_assert(slot != NULL, FX_SLOT_INVALID_PTR);
+    lang_param_assert(fx_slot_is_valid(slot), FX_SLOT_INVALID_OBJ);
+
+    fx_sched_lock(&prev);
+    fx_sync_waitable_lock(&slot->waitable);
+    ++slot->seq;
+
+    if (_fx_sync_waitable_nonempty(&slot->waitable))
+    {
+        fx_sync_wait_block_t* const wb = _fx_sync_wait_block_get(
+            &slot->waitable,
+            slot->policy
+        );
+        fx_slot_deliver(fx_sync_wait_block_get_attr(wb), msg, slot->seq);
+        _fx_sync_wait_notify(&slot->waitable, FX_WAIT_SATISFIED, wb);
+    }
+    else
+    {
+        slot->msg = msg;
+        slot->full = true;
+    }
+
+    fx_sync_waitable_unlock(&slot->waitable);
+    fx_sched_unlock(prev);
+    return FX_SLOT_OK;
+}
+
+//!
+//! Receives the value from the slot. If the slot is empty, calling thread is
+//! blocked until new value is posted or cancel event is set.
+//! @param [in,out] slot Slot object.
+//! @param [out] msg Pointer to location where received value is stored.
+//! @param [out] seq Pointer to location where sequence number of the value is
+//! stored (can be NULL).
+//! @param [in] cancel_ev Optional cancel event (can be NULL).
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int
+fx_slot_receive(
+    fx_slot_t* slot,
+    uintptr_t* msg,
+    uint32_t* seq,
+    fx_event_t* cancel_ev)
+{
+    fx_slot_wait_attr_t attr;
+    lang_param_assert(slot != NULL, FX_SLOT_INVALID_PTR);
+    lang_param_assert(fx_slot_is_valid(slot), FX_SLOT_INVALID_OBJ);
+    lang_param_assert(msg != NULL, FX_SLOT_INVALID_PTR);
+
+    attr.msg = msg;
+    attr.seq = seq;
+    return fx_thread_wait_object(&slot->waitable, &attr, cancel_ev);
+}
+
+//!
+//! Receives the value from the slot with timeout.
+//! @param [in,out] slot Slot object.
+//! @param [out] msg Pointer to location where received value is stored.
+//! @param [out] seq Pointer to location where sequence number of the value is
+//! stored (can be NULL).
+//! @param [in] tout Timeout (in ticks) or FX_THREAD_INFINITE_TIMEOUT value.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int
+fx_slot_timedreceive(
+    fx_slot_t* slot,
+    uintptr_t* msg,
+    uint32_t* seq,
+    uint32_t tout)
+{
+    fx_slot_wait_attr_t attr;
+    lang_param_assert(slot != NULL, FX_SLOT_INVALID_PTR);
+    lang_param_assert(fx_slot_is_valid(slot), FX_SLOT_INVALID_OBJ);
+    lang_param_assert(msg != NULL, FX_SLOT_INVALID_PTR);
+
+    attr.msg = msg;
+    attr.seq = seq;
+    return fx_thread_timedwait_object(&slot->waitable, &attr, tout);
+}
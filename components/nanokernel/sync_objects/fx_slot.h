@@ -0,0 +1,87 @@
+#ifndef _FX_SLOT_V1_HEADER_
+#define _FX_SLOT_V1_HEADER_
+
+/** 
+  ******************************************************************************
+  *  @file   fx_slot.h
+  *  @brief  Single-slot mailbox holding the latest posted value.
+  *  Posting never blocks, new value replaces the previous one if it has not
+  *  been received yet. Each value is tagged with sequence number, so the
+  *  receiver may detect overwritten values.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(LANG_TYPES)
+#include FX_INTERFACE(FX_SYNC)
+#include FX_INTERFACE(FX_THREAD)
+#include FX_INTERFACE(FX_RTP)
+
+enum
+{
+    FX_SLOT_MAGIC = 0x534C4F54, // SLOT
+    FX_SLOT_OK = FX_STATUS_OK,
+    FX_SLOT_INVALID_PTR = FX_THREAD_ERR_MAX,
+    FX_SLOT_INVALID_OBJ,
+    FX_SLOT_UNSUPPORTED_POLICY,
+    FX_SLOT_ERR_MAX
+};
+
+//!
+//! Slot representation.
+//! Sequence number is incremented on each post, so, difference between
+//! sequence numbers of two received values minus one is the number of values
+//! which have been overwritten.
+//!
+typedef struct
+{
+    fx_sync_waitable_t waitable;
+    lock_t lock;
+    uintptr_t msg;
+    uint32_t seq;
+    bool full;
+    fx_sync_policy_t policy;
+    fx_rtp_t rtp;
+}
+fx_slot_t;
+
+int fx_slot_init(fx_slot_t* slot, fx_sync_policy_t p);
+int fx_slot_deinit(fx_slot_t* slot);
+int fx_slot_post(fx_slot_t* slot, uintptr_t msg);
+int fx_slot_receive(
+    fx_slot_t* slot,
+    uintptr_t* msg,
+    uint32_t* seq,
+    fx_event_t* cancel_ev
+);
+int fx_slot_timedreceive(
+    fx_slot_t* slot,
+    uintptr_t* msg,
+    uint32_t* seq,
+    uint32_t tout
+);
+
+FX_METADATA(({ interface: [FX_SLOT, V1] }))
+
+#endif
@@ -0,0 +1,685 @@
+/** 
+  ******************************************************************************
+  *  @file   fx_stream.c
+  *  @brief  Implementation of stream and message buffer.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(FX_STREAM)
+
+FX_METADATA(({ implementation: [FX_STREAM, V1] }))
+
+#define fx_stream_is_valid(s) (fx_rtp_check((&((s)->rtp)), FX_STREAM_MAGIC))
+
+//
+// In message mode each message is prefixed with its length and padded, so,
+// the header and the next message are always properly aligned.
+//
+#define FX_STREAM_HDR_SIZE (sizeof(uintptr_t))
+#define fx_stream_align(sz) \
+    (((sz) + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1))
+
+//
+// Attributes object used to pass parameters to test&wait functions and to get
+// results of the wait. Length is an input for producers and an output for
+// consumers, pointer is an output in both cases.
+//
+typedef struct
+{
+    size_t len;
+    void* ptr;
+}
+fx_stream_wait_attr_t;
+
+//
+// Gets number of bytes which are occupied by the data of specified length.
+//
+static size_t
+fx_stream_footprint(fx_stream_t* stream, size_t len)
+{
+    if (stream->mode == FX_STREAM_MODE_MESSAGES)
+    {
+        return FX_STREAM_HDR_SIZE + fx_stream_align(len);
+    }
+
+    return len;
+}
+
+//
+// Restores canonical positions after read or write. When the reader reaches
+// the watermark it continues from the beginning of the buffer. Empty stream
+// without active reservation is rewound in order to provide the largest
+// contiguous region to the next reservation.
+// Should be called with object locked.
+//
+static void
+fx_stream_normalize(fx_stream_t* stream)
+{
+    if (stream->wrapped && stream->rd == stream->watermark)
+    {
+        stream->rd = 0;
+        stream->wrapped = false;
+    }
+
+    if (stream->count == 0 && stream->res_len == 0)
+    {
+        stream->rd = stream->wr = 0;
+    }
+}
+
+//
+// Tries to reserve contiguous region. If there is not enough space at the end
+// of the buffer, region is placed at the beginning and the tail of the buffer
+// is skipped by the reader once this reservation is committed.
+// Should be called with object locked.
+// @return Pointer to reserved region or NULL if there is no space.
+//
+static void*
+fx_stream_try_reserve(fx_stream_t* stream, size_t len)
+{
+    const size_t total = fx_stream_footprint(stream, len);
+    size_t pos = 0;
+    bool wrap = false;
+
+    if (stream->res_len != 0)
+    {
+        return NULL;
+    }
+
+    if (stream->wrapped)
+    {
+        if (stream->rd - stream->wr < total)
+        {
+            return NULL;
+        }
+
+        pos = stream->wr;
+    }
+    else if (stream->size - stream->wr >= total)
+    {
+        pos = stream->wr;
+    }
+    else if (stream->rd >= total)
+    {
+        wrap = true;
+    }
+    else
+    {
+        return NULL;
+    }
+
+    stream->res_pos = pos;
+    stream->res_len = total;
+    stream->res_wrap = wrap;
+
+    if (stream->mode == FX_STREAM_MODE_MESSAGES)
+    {
+        pos += FX_STREAM_HDR_SIZE;
+    }
+
+    return stream->buf + pos;
+}
+
+//
+// Gets contiguous region of available data (or next message in message mode).
+// Should be called with object locked.
+// @return Length of the region, zero if the stream is empty.
+//
+static size_t
+fx_stream_get_readable(fx_stream_t* stream, void** ptr)
+{
+    const size_t end = stream->wrapped ? stream->watermark : stream->wr;
+    size_t len = end - stream->rd;
+
+    *ptr = stream->buf + stream->rd;
+
+    if (len != 0 && stream->mode == FX_STREAM_MODE_MESSAGES)
+    {
+        len = *((uintptr_t*) *ptr);
+        *ptr = stream->buf + stream->rd + FX_STREAM_HDR_SIZE;
+    }
+
+    return len;
+}
+
+//
+// Makes reservation on behalf of the first waiting producer if there is
+// enough space for it.
+// Should be called with object locked.
+//
+static void
+fx_stream_notify_sender(fx_stream_t* stream)
+{
+    if (stream->res_len == 0 && _fx_sync_waitable_nonempty(&stream->send_wtbl))
+    {
+        fx_sync_wait_block_t* const wb = _fx_sync_wait_block_get(
+            &stream->send_wtbl,
+            stream->policy
+        );
+        fx_stream_wait_attr_t* const attr = fx_sync_wait_block_get_attr(wb);
+        attr->ptr = fx_stream_try_reserve(stream, attr->len);
+
+        if (attr->ptr != NULL)
+        {
+            _fx_sync_wait_notify(&stream->send_wtbl, FX_WAIT_SATISFIED, wb);
+        }
+    }
+}
+
+//
+// Releases the first waiting consumer if amount of data reaches trigger level.
+// Trigger level is ignored if there are blocked producers, since they cannot
+// proceed until the consumer frees some space.
+// Should be called with object locked.
+//
+static void
+fx_stream_notify_receiver(fx_stream_t* stream)
+{
+    const size_t level = (stream->mode == FX_STREAM_MODE_BYTES) ?
+        stream->trigger : 1;
+
+    if (stream->count != 0 && _fx_sync_waitable_nonempty(&stream->recv_wtbl))
+    {
+        if (stream->count >= level ||
+            _fx_sync_waitable_nonempty(&stream->send_wtbl))
+        {
+            fx_sync_wait_block_t* const wb = _fx_sync_wait_block_get(
+                &stream->recv_wtbl,
+                stream->policy
+            );
+            fx_stream_wait_attr_t* const attr = fx_sync_wait_block_get_attr(wb);
+            attr->len = fx_stream_get_readable(stream, &attr->ptr);
+            _fx_sync_wait_notify(&stream->recv_wtbl, FX_WAIT_SATISFIED, wb);
+        }
+    }
+}
+
+//!
+//! Test and wait function for producers. Object is signaled when requested
+//! region is reserved.
+//! @param [in] object Waitable object to be tested.
+//! @param [in] wb Wait block to be inserted into queue if there is no space.
+//! @param [in] wait Wait option.
+//! @return true in case of object is signaled, false otherwise.
+//! @remark SPL = SCHED_LEVEL
+//!
+static bool
+fx_stream_test_and_wait_send(
+    fx_sync_waitable_t* object,
+    fx_sync_wait_block_t* wb,
+    const bool wait)
+{
+    fx_stream_t* const stream = lang_containing_record(
+        object,
+        fx_stream_t,
+        send_wtbl
+    );
+    fx_stream_wait_attr_t* const attr = fx_sync_wait_block_get_attr(wb);
+
+    fx_sync_waitable_lock(object);
+
+    //
+    // Producers which are already waiting for space are not bypassed.
+    //
+    attr->ptr = NULL;
+
+    if (!_fx_sync_waitable_nonempty(object))
+    {
+        attr->ptr = fx_stream_try_reserve(stream, attr->len);
+    }
+
+    if (attr->ptr == NULL && wait)
+    {
+        //
+        // Consumer waiting for trigger level is released, otherwise both
+        // sides would wait for each other forever.
+        //
+        _fx_sync_wait_start(object, wb);
+        fx_stream_notify_receiver(stream);
+    }
+
+    fx_sync_waitable_unlock(object);
+    return attr->ptr != NULL;
+}
+
+//!
+//! Test and wait function for consumers. Object is signaled while the stream
+//! is nonempty, data is not consumed by this function.
+//! @param [in] object Waitable object to be tested.
+//! @param [in] wb Wait block to be inserted into queue if the stream is empty.
+//! @param [in] wait Wait option.
+//! @return true in case of object is signaled, false otherwise.
+//! @remark SPL = SCHED_LEVEL
+//!
+static bool
+fx_stream_test_and_wait_recv(
+    fx_sync_waitable_t* object,
+    fx_sync_wait_block_t* wb,
+    const bool wait)
+{
+    fx_stream_t* const stream = lang_containing_record(
+        object,
+        fx_stream_t,
+        recv_wtbl
+    );
+    fx_stream_wait_attr_t* const attr = fx_sync_wait_block_get_attr(wb);
+    bool nonempty = false;
+
+    fx_sync_waitable_lock(object);
+    nonempty = (stream->count != 0);
+
+    if (nonempty)
+    {
+        attr->len = fx_stream_get_readable(stream, &attr->ptr);
+    }
+    else if (wait)
+    {
+        _fx_sync_wait_start(object, wb);
+    }
+
+    fx_sync_waitable_unlock(object);
+    return nonempty;
+}
+
+//!
+//! Stream constructor.
+//! @param [in,out] stream Stream object to be initialized.
+//! @param [in] buf Buffer to be used as stream storage. In message mode it
+//! must be aligned on pointer size boundary.
+//! @param [in] sz Buffer size in bytes. In message mode it must be multiple of
+//! pointer size.
+//! @param [in] mode Stream mode (bytes or messages).
+//! @param [in] p Waiter notification policy.
+//! @return FX_STREAM_OK in case of success, error code otherwise.
+//!
+int
+fx_stream_init(
+    fx_stream_t* stream,
+    void* buf,
+    size_t sz,
+    fx_stream_mode_t mode,
+    fx_sync_policy_t p)
+{
+    lang_param_assert(stream != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(buf != NULL, FX_STREAM_INVALID_BUF);
+    lang_param_assert(sz > 0, FX_STREAM_INVALID_BUF);
+    lang_param_assert(mode < FX_STREAM_MODE_MAX, FX_STREAM_INVALID_OBJ);
+    lang_param_assert(p < FX_SYNC_POLICY_MAX, FX_STREAM_UNSUPPORTED_POLICY);
+    lang_param_assert(
+        mode == FX_STREAM_MODE_BYTES ||
+        ((((uintptr_t) buf) | sz) & (sizeof(uintptr_t) - 1)) == 0,
+        FX_STREAM_INVALID_BUF
+    );
+
+    fx_spl_spinlock_init(&stream->lock);
+    fx_sync_waitable_init(
+        &stream->send_wtbl,
+        &stream->lock,
+        fx_stream_test_and_wait_send
+    );
+    fx_sync_waitable_init(
+        &stream->recv_wtbl,
+        &stream->lock,
+        fx_stream_test_and_wait_recv
+    );
+    stream->buf = buf;
+    stream->size = sz;
+    stream->rd = stream->wr = 0;
+    stream->watermark = 0;
+    stream->count = 0;
+    stream->trigger = 1;
+    stream->res_pos = stream->res_len = 0;
+    stream->res_wrap = false;
+    stream->wrapped = false;
+    stream->mode = mode;
+    stream->policy = p;
+    fx_rtp_init(&stream->rtp, FX_STREAM_MAGIC);
+    return FX_STREAM_OK;
+}
+
+//!
+//! Stream destructor. All waiters are released with DELETED status.
+//! @param [in,out] stream Stream object to be deinitialized.
+//! @return FX_STREAM_OK in case of success, error code otherwise.
+//!
+int
+fx_stream_deinit(fx_stream_t* stream)
+{
+    fx_sched_state_t prev;
+    lang_param_assert(stream != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(fx_stream_is_valid(stream), FX_STREAM_INVALID_OBJ);
+
+    fx_sched_lock(&prev);
+    fx_rtp_deinit(&stream->rtp);
+    fx_sync_waitable_lock(&stream->send_wtbl);
+    _fx_sync_wait_notify(&stream->send_wtbl, FX_WAIT_DELETED, NULL);
+    _fx_sync_wait_notify(&stream->recv_wtbl, FX_WAIT_DELETED, NULL);
+    fx_sync_waitable_unlock(&stream->send_wtbl);
+    fx_sched_unlock(prev);
+    return FX_STREAM_OK;
+}
+
+//!
+//! Sets trigger level. Blocked consumer is released only when the stream
+//! contains at least specified number of bytes. Consumer which finds the
+//! stream nonempty is not blocked regardless of trigger level. Trigger level
+//! is used in byte mode only, in message mode consumer is released by any
+//! message.
+//! @param [in,out] stream Stream object.
+//! @param [in] level Trigger level in bytes (1 by default).
+//! @return FX_STREAM_OK in case of success, error code otherwise.
+//!
+int
+fx_stream_set_trigger(fx_stream_t* stream, size_t level)
+{
+    fx_sched_state_t prev;
+    lang_param_assert(stream != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(fx_stream_is_valid(stream), FX_STREAM_INVALID_OBJ);
+    lang_param_assert(level > 0, FX_STREAM_INVALID_SIZE);
+    lang_param_assert(level <= stream->size, FX_STREAM_INVALID_SIZE);
+
+    fx_sched_lock(&prev);
+    fx_sync_waitable_lock(&stream->recv_wtbl);
+    stream->trigger = level;
+    fx_stream_notify_receiver(stream);
+    fx_sync_waitable_unlock(&stream->recv_wtbl);
+    fx_sched_unlock(prev);
+    return FX_STREAM_OK;
+}
+
+//!
+//! Reserves contiguous region in the stream. If there is no space, calling
+//! thread is blocked until the consumer frees enough space or cancel event is
+//! set. The region should be filled by the caller and then committed.
+//! @param [in] stream Stream object.
+//! @param [in] len Region length in bytes.
+//! @param [out] ptr Pointer to location where region address is stored.
+//! @param [in] cancel_ev Optional cancel event (can be NULL).
+//! @return Result of wait operation.
+//! @remark SPL = LOW. Region remains reserved until it is committed, all other
+//! producers are blocked on reservation meanwhile.
+//!
+int
+fx_stream_reserve(
+    fx_stream_t* stream,
+    size_t len,
+    void** ptr,
+    fx_event_t* cancel_ev)
+{
+    fx_stream_wait_attr_t attr;
+    int error;
+    lang_param_assert(stream != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(fx_stream_is_valid(stream), FX_STREAM_INVALID_OBJ);
+    lang_param_assert(ptr != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(len > 0, FX_STREAM_INVALID_SIZE);
+    lang_param_assert(
+        fx_stream_footprint(stream, len) <= stream->size,
+        FX_STREAM_INVALID_SIZE
+    );
+
+    attr.len = len;
+    error = fx_thread_wait_object(&stream->send_wtbl, &attr, cancel_ev);
+
+    if (error == FX_STATUS_OK)
+    {
+        *ptr = attr.ptr;
+    }
+
+    return error;
+}
+
+//!
+//! Reserves contiguous region in the stream with timeout.
+//! @param [in] stream Stream object.
+//! @param [in] len Region length in bytes.
+//! @param [out] ptr Pointer to location where region address is stored.
+//! @param [in] tout Timeout (in ticks) or FX_THREAD_INFINITE_TIMEOUT value.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int
+fx_stream_timedreserve(
+    fx_stream_t* stream,
+    size_t len,
+    void** ptr,
+    uint32_t tout)
+{
+    fx_stream_wait_attr_t attr;
+    int error;
+    lang_param_assert(stream != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(fx_stream_is_valid(stream), FX_STREAM_INVALID_OBJ);
+    lang_param_assert(ptr != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(len > 0, FX_STREAM_INVALID_SIZE);
+    lang_param_assert(
+        fx_stream_footprint(stream, len) <= stream->size,
+        FX_STREAM_INVALID_SIZE
+    );
+
+    attr.len = len;
+    error = fx_thread_timedwait_object(&stream->send_wtbl, &attr, tout);
+
+    if (error == FX_STATUS_OK)
+    {
+        *ptr = attr.ptr;
+    }
+
+    return error;
+}
+
+//!
+//! Publishes data written into reserved region. Committed length may be less
+//! than reserved one, zero length cancels the reservation.
+//! In message mode committed data forms a single message.
+//! @param [in] stream Stream object.
+//! @param [in] len Number of bytes written into reserved region.
+//! @return FX_STREAM_OK in case of success, error code otherwise.
+//! @remark SPL <= DISPATCH
+//!
+int
+fx_stream_commit(fx_stream_t* stream, size_t len)
+{
+    fx_sched_state_t prev;
+    int error = FX_STREAM_OK;
+    lang_param_assert(stream != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(fx_stream_is_valid(stream), FX_STREAM_INVALID_OBJ);
+
+    fx_sched_lock(&prev);
+    fx_sync_waitable_lock(&stream->send_wtbl);
+
+    if (stream->res_len == 0)
+    {
+        error = FX_STREAM_NO_RESERVATION;
+    }
+    else if (fx_stream_footprint(stream, len) > stream->res_len)
+    {
+        error = FX_STREAM_INVALID_SIZE;
+    }
+    else
+    {
+        if (len != 0)
+        {
+            if (stream->mode == FX_STREAM_MODE_MESSAGES)
+            {
+                *((uintptr_t*) (stream->buf + stream->res_pos)) = len;
+            }
+
+            //
+            // Data in the upper part of the buffer ends at the current write
+            // position if the reservation has been placed at the beginning.
+            //
+            if (stream->res_wrap)
+            {
+                stream->watermark = stream->wr;
+                stream->wrapped = true;
+            }
+
+            stream->wr = stream->res_pos + fx_stream_footprint(stream, len);
+            stream->count += fx_stream_footprint(stream, len);
+        }
+
+        stream->res_len = 0;
+        fx_stream_normalize(stream);
+        fx_stream_notify_sender(stream);
+        fx_stream_notify_receiver(stream);
+    }
+
+    fx_sync_waitable_unlock(&stream->send_wtbl);
+    fx_sched_unlock(prev);
+    return error;
+}
+
+//!
+//! Gets contiguous region of available data. If the stream is empty, calling
+//! thread is blocked until the producer commits data up to trigger level or
+//! cancel event is set. Data remains in the stream until it is consumed.
+//! @param [in] stream Stream object.
+//! @param [out] ptr Pointer to location where data address is stored.
+//! @param [out] len Pointer to location where data length is stored. In byte
+//! mode it may be less than total amount of data if the data is wrapped
+//! around. In message mode it is length of the next message.
+//! @param [in] cancel_ev Optional cancel event (can be NULL).
+//! @return Result of wait operation.
+//! @remark SPL = LOW. Only one consumer is allowed at any given moment.
+//!
+int
+fx_stream_peek(
+    fx_stream_t* stream,
+    void** ptr,
+    size_t* len,
+    fx_event_t* cancel_ev)
+{
+    fx_stream_wait_attr_t attr;
+    int error;
+    lang_param_assert(stream != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(fx_stream_is_valid(stream), FX_STREAM_INVALID_OBJ);
+    lang_param_assert(ptr != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(len != NULL, FX_STREAM_INVALID_PTR);
+
+    error = fx_thread_wait_object(&stream->recv_wtbl, &attr, cancel_ev);
+
+    if (error == FX_STATUS_OK)
+    {
+        *ptr = attr.ptr;
+        *len = attr.len;
+    }
+
+    return error;
+}
+
+//!
+//! Gets contiguous region of available data with timeout.
+//! @param [in] stream Stream object.
+//! @param [out] ptr Pointer to location where data address is stored.
+//! @param [out] len Pointer to location where data length is stored.
+//! @param [in] tout Timeout (in ticks) or FX_THREAD_INFINITE_TIMEOUT value.
+//! @return Result of wait operation.
+//! @remark SPL = LOW. Only one consumer is allowed at any given moment.
+//!
+int
+fx_stream_timedpeek(
+    fx_stream_t* stream,
+    void** ptr,
+    size_t* len,
+    uint32_t tout)
+{
+    fx_stream_wait_attr_t attr;
+    int error;
+    lang_param_assert(stream != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(fx_stream_is_valid(stream), FX_STREAM_INVALID_OBJ);
+    lang_param_assert(ptr != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(len != NULL, FX_STREAM_INVALID_PTR);
+
+    error = fx_thread_timedwait_object(&stream->recv_wtbl, &attr, tout);
+
+    if (error == FX_STATUS_OK)
+    {
+        *ptr = attr.ptr;
+        *len = attr.len;
+    }
+
+    return error;
+}
+
+//!
+//! Releases data obtained by peek. Freed space is used to satisfy blocked
+//! producers.
+//! @param [in] stream Stream object.
+//! @param [in] len Number of bytes to be consumed. It must not exceed the
+//! length returned by peek. In message mode it must be equal to message
+//! length, since messages are always consumed as a whole.
+//! @return FX_STREAM_OK in case of success, error code otherwise.
+//! @remark SPL <= DISPATCH
+//!
+int
+fx_stream_consume(fx_stream_t* stream, size_t len)
+{
+    fx_sched_state_t prev;
+    int error = FX_STREAM_OK;
+    void* ptr = NULL;
+    size_t avail = 0;
+    lang_param_assert(stream != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(fx_stream_is_valid(stream), FX_STREAM_INVALID_OBJ);
+
+    fx_sched_lock(&prev);
+    fx_sync_waitable_lock(&stream->recv_wtbl);
+    avail = fx_stream_get_readable(stream, &ptr);
+
+    if (len > avail ||
+        (stream->mode == FX_STREAM_MODE_MESSAGES && len != avail))
+    {
+        error = FX_STREAM_INVALID_SIZE;
+    }
+    else if (len != 0)
+    {
+        const size_t total = fx_stream_footprint(stream, len);
+
+        stream->rd += total;
+        stream->count -= total;
+        fx_stream_normalize(stream);
+        fx_stream_notify_sender(stream);
+    }
+
+    fx_sync_waitable_unlock(&stream->recv_wtbl);
+    fx_sched_unlock(prev);
+    return error;
+}
+
+//!
+//! Gets number of bytes stored in the stream (including message headers in
+//! message mode).
+//! @param [in] stream Stream object.
+//! @param [out] count Pointer to location where number of bytes is stored.
+//! @return FX_STREAM_OK in case of success, error code otherwise.
+//!
+int
+fx_stream_get_count(fx_stream_t* stream, size_t* count)
+{
+    lang_param_assert(stream != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(count != NULL, FX_STREAM_INVALID_PTR);
+    lang_param_assert(fx_stream_is_valid(stream), FX_STREAM_INVALID_OBJ);
+
+    *count = stream->count;
+    return FX_STREAM_OK;
+}
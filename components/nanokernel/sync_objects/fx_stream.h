@@ -0,0 +1,135 @@
+#ifndef _FX_STREAM_V1_HEADER_
+#define _FX_STREAM_V1_HEADER_
+
+/** 
+  ******************************************************************************
+  *  @file   fx_stream.h
+  *  @brief  Variable-length stream and message buffer.
+  *  Producer reserves contiguous region in the buffer, fills it in place and
+  *  commits written bytes. Consumer peeks contiguous region of available data
+  *  and consumes it when processed. So, data is not copied by the kernel.
+  *  In message mode each committed region is a separate message, the consumer
+  *  always gets whole messages.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(LANG_TYPES)
+#include FX_INTERFACE(FX_SYNC)
+#include FX_INTERFACE(FX_THREAD)
+#include FX_INTERFACE(FX_RTP)
+
+enum
+{
+    FX_STREAM_MAGIC = 0x5354524D, // STRM
+    FX_STREAM_OK = FX_STATUS_OK,
+    FX_STREAM_INVALID_PTR = FX_THREAD_ERR_MAX,
+    FX_STREAM_INVALID_OBJ,
+    FX_STREAM_INVALID_BUF,
+    FX_STREAM_INVALID_SIZE,
+    FX_STREAM_UNSUPPORTED_POLICY,
+    FX_STREAM_NO_RESERVATION,
+    FX_STREAM_ERR_MAX
+};
+
+//!
+//! Stream modes.
+//!
+typedef enum
+{
+    FX_STREAM_MODE_BYTES = 0,
+    FX_STREAM_MODE_MESSAGES,
+    FX_STREAM_MODE_MAX
+}
+fx_stream_mode_t;
+
+//!
+//! Stream buffer representation.
+//! Data is stored between read and write positions. When the reservation does
+//! not fit into the end of the buffer it is placed at the beginning, in this
+//! case the stream becomes wrapped and data in the upper part ends at the
+//! watermark. Only one reservation may be active at any given moment.
+//!
+typedef struct
+{
+    fx_sync_waitable_t send_wtbl;
+    fx_sync_waitable_t recv_wtbl;
+    lock_t lock;
+    uint8_t* buf;
+    size_t size;
+    size_t rd;
+    size_t wr;
+    size_t watermark;
+    size_t count;
+    size_t trigger;
+    size_t res_pos;
+    size_t res_len;
+    bool res_wrap;
+    bool wrapped;
+    fx_stream_mode_t mode;
+    fx_sync_policy_t policy;
+    fx_rtp_t rtp;
+}
+fx_stream_t;
+
+int fx_stream_init(
+    fx_stream_t* stream,
+    void* buf,
+    size_t sz,
+    fx_stream_mode_t mode,
+    fx_sync_policy_t p
+);
+int fx_stream_deinit(fx_stream_t* stream);
+int fx_stream_set_trigger(fx_stream_t* stream, size_t level);
+int fx_stream_reserve(
+    fx_stream_t* stream,
+    size_t len,
+    void** ptr,
+    fx_event_t* cancel_ev
+);
+int fx_stream_timedreserve(
+    fx_stream_t* stream,
+    size_t len,
+    void** ptr,
+    uint32_t tout
+);
+int fx_stream_commit(fx_stream_t* stream, size_t len);
+int fx_stream_peek(
+    fx_stream_t* stream,
+    void** ptr,
+    size_t* len,
+    fx_event_t* cancel_ev
+);
+int fx_stream_timedpeek(
+    fx_stream_t* stream,
+    void** ptr,
+    size_t* len,
+    uint32_t tout
+);
+int fx_stream_consume(fx_stream_t* stream, size_t len);
+int fx_stream_get_count(fx_stream_t* stream, size_t* count);
+
+FX_METADATA(({ interface: [FX_STREAM, V1] }))
+
+#endif
@@ -41,6 +41,14 @@
 #include FX_INTERFACE(FX_RTP)
 #include FX_INTERFACE(FX_STACKOVF)  
 #include FX_INTERFACE(TRACE_CORE) 
+
+#ifndef FX_THREAD_WAIT_MULTIPLE_MAX
+#define FX_THREAD_WAIT_MULTIPLE_MAX 8
+#endif
+
+#ifndef FX_THREAD_ADDR_BUCKETS
+#define FX_THREAD_ADDR_BUCKETS 16
+#endif
   
 //!
 //! Thread states.
@@ -64,6 +72,8 @@ enum
     FX_THREAD_PARAM_PRIO = 0,
     FX_THREAD_PARAM_TIMESLICE = 1,
     FX_THREAD_PARAM_CPU = 2,
+    FX_THREAD_PARAM_DEADLINE = 3,
+    FX_THREAD_PARAM_PREEMPT_THRESHOLD = 4,
     FX_THREAD_PARAM_MAX,
 
     //
@@ -89,9 +99,74 @@ enum
 };
 
 //!
-//! Thread representation.
+//! Wait modes for fx_thread_wait_multiple.
+//!
+typedef enum
+{
+    FX_THREAD_WAIT_ANY = 0,         // Wait for any of objects (OR).
+    FX_THREAD_WAIT_ALL = 1,         // Wait for all objects (AND).
+    FX_THREAD_WAIT_MODE_MAX
+}
+fx_thread_wait_mode_t;
+
+//!
+//! Object descriptor for fx_thread_wait_multiple. Attribute is object-specific
+//! parameter which is passed to wait functions (i.e. pointer to message buffer
+//! for message queues or pointer to block pointer for block pools).
+//!
+typedef struct
+{
+    fx_sync_waitable_t* object;
+    void* attr;
+}
+fx_thread_wait_item_t;
+
+//!
+//! Actions performed on thread's notification value by fx_thread_notify.
+//!
+typedef enum
+{
+    FX_THREAD_NOTIFY_SET_BITS = 0,  // Value is ORed with specified bits.
+    FX_THREAD_NOTIFY_INCREMENT = 1, // Value is incremented (bits are ignored).
+    FX_THREAD_NOTIFY_OVERWRITE = 2, // Value is replaced by specified bits.
+    FX_THREAD_NOTIFY_ACTION_MAX
+}
+fx_thread_notify_action_t;
+
+//!
+//! CPU time statistics of the thread (in units of HAL cycle counter).
+//! Interrupt time is the time spent in ISRs which interrupted the thread, it 
+//! is not included into run time.
+//!
+typedef struct
+{
+    uint64_t run_cycles;
+    uint64_t intr_cycles;
+}
+fx_thread_stats_t;
+
+struct _fx_thread_t;
+
+//!
+//! Object affecting priority of its owner thread (i.e. mutex). The owner 
+//! inherits priority of the most prioritized waiter of the waitable (if it is
+//! not NULL) and ceiling priority (if it is not NULL). Priority of the thread 
+//! is the highest one of its base priority and priorities inherited from all 
+//! owned objects.
 //!
 typedef struct
+{
+    rtl_queue_linkage_t link;
+    struct _fx_thread_t* owner;
+    fx_sync_waitable_t* waitable;
+    const fx_sched_params_t* ceiling;
+}
+fx_thread_pi_t;
+
+//!
+//! Thread representation.
+//!
+typedef struct _fx_thread_t
 {
     fx_rtp_t rtp;
     fx_process_t* parent;
@@ -108,6 +183,14 @@ typedef struct
     lock_t state_lock;
     fx_thread_state_t state;
     bool is_terminating;
+    fx_sched_params_t base_params;
+    rtl_queue_t pi_objects;
+    fx_thread_pi_t* pi_blocked_on;
+    struct _fx_thread_notify_wait_t* notify_wait;
+    uint32_t notify_value;
+#if defined FX_THREAD_CPU_STATS
+    fx_thread_stats_t stats;
+#endif
     trace_thread_handle_t trace_handle;
 }
 fx_thread_t;
@@ -128,11 +211,38 @@ bool fx_thread_send_apc(fx_thread_t* thread, fx_thread_apc_msg_t* msg);
 #define fx_thread_cancel_apc(t, a) fx_thread_apc_cancel(&((t)->apcs), a)
 #define fx_thread_enter_critical_region() ((void) fx_thread_apc_set_mask(true))
 #define fx_thread_leave_critical_region() ((void) fx_thread_apc_set_mask(false))
+void fx_thread_pi_init(
+    fx_thread_pi_t* pi, 
+    fx_sync_waitable_t* waitable, 
+    const fx_sched_params_t* ceiling
+);
+void fx_thread_pi_acquire(fx_thread_pi_t* pi, fx_thread_t* owner);
+void fx_thread_pi_release(fx_thread_pi_t* pi);
+void fx_thread_pi_block(fx_thread_t* thread, fx_thread_pi_t* pi);
+void fx_thread_pi_unblock(fx_thread_t* thread);
+void fx_thread_pi_update(fx_thread_t* thread);
+
+#if defined FX_THREAD_ADDR_WAIT
+void fx_thread_addr_ctor(void);
+#else
+#define fx_thread_addr_ctor()
+#endif
+
+#if defined FX_THREAD_CPU_STATS
+void fx_thread_stats_ctor(void);
+void fx_thread_stats_init(fx_thread_t* thread);
+void fx_thread_stats_switch(fx_thread_t* prev);
+#else
+#define fx_thread_stats_ctor()
+#define fx_thread_stats_init(thread)
+#define fx_thread_stats_switch(prev)
+#endif
 
 //
 // Public API.
 //
 #define FX_THREAD_INFINITE_TIMEOUT UINT32_C(0xFFFFFFFF)
+#define FX_THREAD_WAKE_ALL (~0U)
 #define fx_thread_init(a, b, c, d, e, f, g) \
     fx_thread_init_ex(fx_process_self(), a, b, c, d, e, f, g)
 
@@ -160,7 +270,51 @@ int fx_thread_get_params(fx_thread_t* thread, unsigned int t, unsigned int* v);
 int fx_thread_set_params(fx_thread_t* thread, unsigned int t, unsigned int v);
 int fx_thread_wait_event(fx_event_t* event, fx_event_t* cancel_event);
 int fx_thread_timedwait_event(fx_event_t* event, uint32_t timeout);
+int fx_thread_notify(
+    fx_thread_t* thread, 
+    fx_thread_notify_action_t action, 
+    uint32_t bits
+);
+int fx_thread_notify_wait(uint32_t mask, uint32_t timeout, uint32_t* value);
+int fx_thread_notify_take(bool clear, uint32_t timeout, uint32_t* value);
+int fx_thread_wait_multiple(
+    const fx_thread_wait_item_t* objects, 
+    unsigned int n, 
+    fx_thread_wait_mode_t mode, 
+    uint32_t timeout, 
+    unsigned int* index
+);
+
+#if defined FX_THREAD_ADDR_WAIT
+int fx_thread_wait_address(
+    volatile uint32_t* addr, 
+    uint32_t expected, 
+    uint32_t timeout
+);
+int fx_thread_wake_address(volatile uint32_t* addr, unsigned int n);
+#endif
+
+#if defined FX_THREAD_CPU_STATS
+int fx_thread_get_stats(fx_thread_t* thread, fx_thread_stats_t* stats);
+int fx_thread_get_idle_stats(fx_thread_stats_t* stats);
+void fx_thread_intr_enter(void);
+void fx_thread_intr_exit(void);
+#endif
 
 FX_METADATA(({ interface: [FX_THREAD, V1] }))
 
+FX_METADATA(({ options: [
+    FX_THREAD_WAIT_MULTIPLE_MAX: {
+        type: int, range: [2, 32], default: 8,
+        description: "Maximum number of objects in single multiple wait."},
+    FX_THREAD_ADDR_WAIT: {
+        type: int, range: [0, 1], default: 0,
+        description: "Enable waiting on arbitrary addresses."},
+    FX_THREAD_ADDR_BUCKETS: {
+        type: int, range: [1, 256], default: 16,
+        description: "Number of address wait queues (power of two)."},
+    FX_THREAD_CPU_STATS: {
+        type: int, range: [0, 1], default: 0,
+        description: "Account CPU time consumed by each thread."}]}))
+
 #endif
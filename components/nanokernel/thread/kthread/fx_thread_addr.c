@@ -0,0 +1,201 @@
+/** 
+  ******************************************************************************
+  *  @file   fx_thread_addr.c
+  *  @brief  Waiting on user-provided memory location.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(FX_THREAD)
+
+FX_METADATA(({ implementation: [FX_THREAD, V1] }))
+
+#if defined FX_THREAD_ADDR_WAIT
+
+lang_static_assert(
+    (FX_THREAD_ADDR_BUCKETS & (FX_THREAD_ADDR_BUCKETS - 1)) == 0
+);
+
+//
+// Waiters are placed into one of the hashed queues according to the address
+// being waited. Addresses may collide, so, attribute of the wait block points
+// to the structure on the waiter's stack containing the address and the waker
+// checks it before the waiter is released.
+//
+typedef struct
+{
+    fx_sync_waitable_t waitable;
+    lock_t lock;
+}
+fx_thread_addr_bucket_t;
+
+typedef struct
+{
+    volatile uint32_t* addr;
+    uint32_t expected;
+}
+fx_thread_addr_attr_t;
+
+static fx_thread_addr_bucket_t g_addr_buckets[FX_THREAD_ADDR_BUCKETS];
+
+//
+// Gets queue for specified address. Low bits are always zero for aligned
+// words, so, they are skipped and higher bits are folded into index.
+//
+static fx_sync_waitable_t*
+fx_thread_addr_get_queue(volatile uint32_t* addr)
+{
+    uintptr_t h = ((uintptr_t) addr) >> 2;
+    h ^= h >> 8;
+    h ^= h >> 16;
+    return &g_addr_buckets[h & (FX_THREAD_ADDR_BUCKETS - 1)].waitable;
+}
+
+//
+// Test and wait function. Wait is skipped if the value at the address does
+// not match expected one, otherwise the waiter is inserted into the queue.
+// Since the value is checked with the queue locked, wakeup performed after
+// the value is changed cannot be missed.
+// @remark SPL = SCHED_LEVEL
+//
+static bool
+fx_thread_addr_test_and_wait(
+    fx_sync_waitable_t* object,
+    fx_sync_wait_block_t* wb,
+    const bool wait)
+{
+    fx_thread_addr_attr_t* const attr = fx_sync_wait_block_get_attr(wb);
+    bool satisfied = false;
+
+    fx_sync_waitable_lock(object);
+    satisfied = (*attr->addr != attr->expected);
+
+    if (!satisfied && wait)
+    {
+        _fx_sync_wait_start(object, wb);
+    }
+
+    fx_sync_waitable_unlock(object);
+    return satisfied;
+}
+
+//!
+//! Initializes wait queues. Called by thread module constructor.
+//!
+void
+fx_thread_addr_ctor(void)
+{
+    unsigned int i;
+
+    for (i = 0; i < FX_THREAD_ADDR_BUCKETS; ++i)
+    {
+        fx_spl_spinlock_init(&g_addr_buckets[i].lock);
+        fx_sync_waitable_init(
+            &g_addr_buckets[i].waitable,
+            &g_addr_buckets[i].lock,
+            fx_thread_addr_test_and_wait
+        );
+    }
+}
+
+//!
+//! Waits until the value at specified address is changed. If the value does
+//! not match expected one, the function returns immediately. Otherwise the
+//! calling thread is blocked until it is woken by fx_thread_wake_address (or
+//! timeout expires). Since wakeups may be caused by another address sharing
+//! the same queue, caller should check the value again after return.
+//! @param [in] addr Address of the value.
+//! @param [in] expected Value which causes the caller to wait.
+//! @param [in] timeout Timeout value. Use special value
+//! FX_THREAD_INFINITE_TIMEOUT for infinite.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int
+fx_thread_wait_address(
+    volatile uint32_t* addr,
+    uint32_t expected,
+    uint32_t timeout)
+{
+    fx_thread_addr_attr_t attr;
+    lang_param_assert(addr != NULL, FX_THREAD_INVALID_PTR);
+
+    attr.addr = addr;
+    attr.expected = expected;
+    return fx_thread_timedwait_object(
+        fx_thread_addr_get_queue(addr),
+        &attr,
+        timeout
+    );
+}
+
+//!
+//! Wakes threads waiting on specified address. Threads are released in FIFO
+//! order. Queue is checked before the scheduler is locked, so, if there are
+//! no waiters in the queue, the function returns immediately.
+//! @param [in] addr Address of the value.
+//! @param [in] n Maximum number of threads to be woken. Use
+//! FX_THREAD_WAKE_ALL in order to wake all waiters.
+//! @return FX_THREAD_OK in case of success, error code otherwise.
+//! @warning Value at the address must be changed before this function is
+//! called.
+//! @remark SPL <= DISPATCH.
+//!
+int
+fx_thread_wake_address(volatile uint32_t* addr, unsigned int n)
+{
+    fx_sync_waitable_t* const object = fx_thread_addr_get_queue(addr);
+    rtl_queue_t* const head = fx_sync_waitable_as_queue(object);
+    rtl_queue_t* item = NULL;
+    fx_sched_state_t prev;
+    lang_param_assert(addr != NULL, FX_THREAD_INVALID_PTR);
+
+    if (!_fx_sync_waitable_nonempty(object))
+    {
+        return FX_THREAD_OK;
+    }
+
+    fx_sched_lock(&prev);
+    fx_sync_waitable_lock(object);
+    item = rtl_queue_first(head);
+
+    while (item != head && n != 0)
+    {
+        fx_sync_wait_block_t* const wb = fx_sync_queue_item_as_wb(item);
+        fx_thread_addr_attr_t* const attr = fx_sync_wait_block_get_attr(wb);
+        item = rtl_queue_next(item);
+
+        if (attr->addr == addr)
+        {
+            _fx_sync_wait_notify(object, FX_WAIT_SATISFIED, wb);
+            --n;
+        }
+    }
+
+    fx_sync_waitable_unlock(object);
+    fx_sched_unlock(prev);
+    return FX_THREAD_OK;
+}
+
+#endif
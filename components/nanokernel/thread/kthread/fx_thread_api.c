@@ -42,6 +42,36 @@ int fx_thread_wait_object_internal(
     fx_event_internal_t* cancel
 );
 
+void fx_thread_notify_init(fx_thread_t* thread);
+
+//
+// Sets absolute deadline of the thread or resets it if the thread is not 
+// timed. Deadline is the part of base scheduling parameters, actual ones are
+// recalculated since the thread may own mutexes. Scheduler containers which 
+// do not support deadlines ignore them, so, parameters are not changed.
+// @remark SPL = SCHED_LEVEL
+//
+static void
+fx_thread_set_deadline(fx_thread_t* thread, uint32_t deadline, bool timed)
+{
+    fx_sched_params_t params;
+    fx_sched_params_copy(&thread->base_params, &params);
+
+    if (timed)
+    {
+        fx_sched_params_set_deadline(&thread->base_params, deadline);
+    }
+    else
+    {
+        fx_sched_params_reset_deadline(&thread->base_params);
+    }
+
+    if (!fx_sched_params_is_equal(&params, &thread->base_params))
+    {
+        fx_thread_pi_update(thread);
+    }
+}
+
 //!
 //! Initialize new thread.
 //! @param [in] parent Parent process.
@@ -80,6 +110,9 @@ fx_thread_init_ex(
     thread->is_terminating = false;
     thread->timeslice = 0;
     fx_sched_params_init_prio(&params, priority);
+    fx_sched_params_copy(&params, &thread->base_params);
+    rtl_queue_init(&thread->pi_objects);
+    thread->pi_blocked_on = NULL;
     fx_sched_item_init(
         &thread->sched_item, 
         FX_SCHED_PARAMS_INIT_SPECIFIED, 
@@ -96,6 +129,8 @@ fx_thread_init_ex(
     fx_event_internal_init(&thread->timer_event, false);
     fx_stackovf_init(&thread->stk_info, stack, stack_sz);
     fx_spl_spinlock_init(&thread->state_lock);
+    fx_thread_notify_init(thread);
+    fx_thread_stats_init(thread);
     trace_thread_init(
         &thread->trace_handle, 
         fx_sched_item_as_number(&thread->sched_item)
@@ -354,8 +389,15 @@ fx_thread_sleep(uint32_t ticks)
 //!
 //! Sets thread scheduling parameters.
 //! @param [in] thread Thread object to set parameters to.
-//! @param [in] type Type of parameter to change (priority, timeslice or CPU).
-//! @param [in] value Value of appropriate type (priority, timeslice or CPU).
+//! @param [in] type Type of parameter to change (priority, timeslice, CPU, 
+//! deadline or preemption threshold).
+//! @param [in] value Value of appropriate type (priority, timeslice, CPU, 
+//! deadline or threshold). Deadline is specified in ticks relative to current 
+//! time, 0 means no deadline. Deadline is only supported by EDF scheduler 
+//! container, other containers ignore it. Threshold is a priority value, 
+//! while the thread is running it may be preempted only by threads with 
+//! priority higher than the threshold. Threshold which is not higher than 
+//! thread's priority has no effect.
 //! @return FX_STATUS_OK if succeeded, error code otherwise.
 //!
 int
@@ -375,9 +417,23 @@ fx_thread_set_params(fx_thread_t* thread, unsigned int type, unsigned int value)
         {
             fx_sched_params_t params;
             fx_sched_params_init_prio(&params, value);
-            fx_spl_spinlock_get_from_sched(&thread->state_lock);
-            fx_sched_item_set_params(&thread->sched_item, &params);
-            fx_spl_spinlock_put_from_sched(&thread->state_lock);
+
+            if (fx_sched_params_has_deadline(&thread->base_params))
+            {
+                fx_sched_params_set_deadline(
+                    &params, 
+                    fx_sched_params_get_deadline(&thread->base_params)
+                );
+            }
+
+            //
+            // Base priority is changed. Actual priority may be higher if the
+            // thread owns mutexes. If the thread is blocked, its wait blocks 
+            // are moved to appropriate position in priority-ordered queues 
+            // and new priority is propagated to owners of inheriting mutexes.
+            //
+            fx_sched_params_copy(&params, &thread->base_params);
+            fx_thread_pi_update(thread);
             trace_thread_sched_param_set(
                 &thread->trace_handle, 
                 fx_sched_params_as_number(params)
@@ -413,6 +469,34 @@ fx_thread_set_params(fx_thread_t* thread, unsigned int type, unsigned int value)
         }
         break;
 
+    case FX_THREAD_PARAM_DEADLINE:
+        if (value < FX_TIMER_MAX_RELATIVE_TIMEOUT)
+        {
+            fx_thread_set_deadline(
+                thread, 
+                fx_timer_get_tick_count() + value, 
+                value != 0
+            );
+        }
+        else
+        {
+            error = FX_THREAD_INVALID_TIMEOUT;
+        }
+        break;
+
+    case FX_THREAD_PARAM_PREEMPT_THRESHOLD:
+        if (value <= FX_SCHED_ALG_PRIO_IDLE)
+        {
+            fx_sched_params_t params;
+            fx_sched_params_init_prio(&params, value);
+            fx_sched_item_set_threshold(&thread->sched_item, &params);
+        }
+        else
+        {
+            error = FX_THREAD_INVALID_PRIO;
+        }
+        break;
+
     default: error = FX_THREAD_INVALID_PARAM; break;
     };
 
@@ -423,9 +507,11 @@ fx_thread_set_params(fx_thread_t* thread, unsigned int type, unsigned int value)
 //!
 //! Getting of thread scheduling parameters.
 //! @param [in] thread Thread to get parameters from.
-//! @param [in] type Type of parameter to get (priority, timeslice or CPU).
+//! @param [in] type Type of parameter to get (priority, timeslice, CPU, 
+//! deadline or preemption threshold).
 //! @param [in] value Pointer to value of appropriate type (priority, 
-//! timeslice or CPU number).
+//! timeslice, CPU number, ticks remaining to deadline (0 if the thread has 
+//! no deadline or it is already missed) or threshold priority).
 //! @return FX_STATUS_OK if succeeded, error code otherwise.
 //!
 int
@@ -458,6 +544,24 @@ fx_thread_get_params(fx_thread_t* thread, unsigned int type,unsigned int* value)
         *value = (unsigned int) affinity;
         break;
 
+    case FX_THREAD_PARAM_DEADLINE:
+        *value = 0;
+
+        if (fx_sched_params_has_deadline(&thread->base_params))
+        {
+            const int32_t remaining = (int32_t) (
+                fx_sched_params_get_deadline(&thread->base_params) - 
+                fx_timer_get_tick_count()
+            );
+            *value = remaining > 0 ? (unsigned int) remaining : 0;
+        }
+        break;
+
+    case FX_THREAD_PARAM_PREEMPT_THRESHOLD:
+        fx_sched_item_get_threshold(&thread->sched_item, &params);
+        *value = fx_sched_params_as_number(&params);
+        break;
+
     default: error = FX_THREAD_INVALID_PARAM; break;
     };
 
@@ -504,6 +608,7 @@ fx_thread_delay_until(uint32_t* prev_wake, uint32_t increment)
     fx_timer_internal_t* const timer = &me->timer;
     fx_event_internal_t* const timeout_event = &me->timer_event;
     const uint32_t time_to_wake = *prev_wake + increment;
+    fx_sched_state_t prev;
 
     lang_param_assert(prev_wake != NULL, FX_THREAD_INVALID_PTR);
     lang_param_assert(
@@ -514,6 +619,17 @@ fx_thread_delay_until(uint32_t* prev_wake, uint32_t increment)
     *prev_wake = time_to_wake;
     trace_thread_delay_until(&me->trace_handle, time_to_wake);
     fx_event_internal_reset(timeout_event);
+
+    //
+    // Periodic thread gets implicit deadline: the job released at the wakeup 
+    // time must be completed by the start of the next period. Deadline is 
+    // also advanced if the wakeup time has already passed (overrun), 
+    // otherwise the thread would keep expired deadline of the previous job.
+    //
+    fx_sched_lock(&prev);
+    fx_thread_set_deadline(me, time_to_wake + increment, true);
+    fx_sched_unlock(prev);
+
     if (!fx_timer_internal_set_abs(timer, time_to_wake, 0))
     {
         error = fx_thread_wait_object_internal(
@@ -0,0 +1,281 @@
+/** 
+  ******************************************************************************
+  *  @file   fx_thread_notify.c
+  *  @brief  Direct-to-thread notifications.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(FX_THREAD)
+
+FX_METADATA(({ implementation: [FX_THREAD, V1] }))
+
+int fx_thread_wait_object_internal(
+    fx_thread_t* self, 
+    fx_sync_waitable_t* object, 
+    void* attr, 
+    fx_event_internal_t* cancel
+);
+
+//
+// Notification value is protected by the scheduler lock. Only the owner thread
+// may wait for notifications, so, no waitable object is used: the waiting 
+// thread publishes pointer to the structure on its stack containing mask of 
+// interesting bits and consumption mode, and sleeps on its own timer event. 
+// Notifier consumes the value on behalf of the waiter, resets the pointer and 
+// sets the event. If the pointer is still set after wakeup, the wait was 
+// completed by timeout or interrupted.
+//
+typedef struct _fx_thread_notify_wait_t
+{
+    uint32_t mask;
+    bool decrement;
+    uint32_t value;
+}
+fx_thread_notify_wait_t;
+
+//
+// Tries to consume notification value. Bits specified in the mask are cleared
+// or, in decrement mode, the value is decremented by one.
+// @return true if value matches the mask (and it is consumed).
+// @remark SPL = SCHED_LEVEL
+//
+static bool
+fx_thread_notify_consume(fx_thread_t* thread, fx_thread_notify_wait_t* wait)
+{
+    const uint32_t value = thread->notify_value;
+
+    if (value & wait->mask)
+    {
+        wait->value = value;
+        thread->notify_value = wait->decrement ? 
+            value - 1 : 
+            value & ~wait->mask;
+        return true;
+    }
+
+    return false;
+}
+
+//
+// Waits for notification of calling thread.
+// @param [in,out] wait Wait descriptor.
+// @param [in] timeout Timeout value.
+// @return Result of wait operation.
+// @remark SPL = LOW
+//
+static int
+fx_thread_notify_wait_internal(fx_thread_notify_wait_t* wait, uint32_t timeout)
+{
+    fx_thread_t* const me = fx_thread_self();
+    fx_event_internal_t* const wake_event = &me->timer_event;
+    int error = FX_THREAD_WAIT_TIMEOUT;
+    fx_sched_state_t prev;
+
+    lang_param_assert(
+        timeout < FX_TIMER_MAX_RELATIVE_TIMEOUT || 
+            timeout == FX_THREAD_INFINITE_TIMEOUT, 
+        FX_THREAD_INVALID_TIMEOUT
+    );
+
+    fx_sched_lock(&prev);
+
+    if (fx_thread_notify_consume(me, wait))
+    {
+        error = FX_THREAD_OK;
+    }
+    else if (timeout != 0)
+    {
+        fx_event_internal_reset(wake_event);
+        me->notify_wait = wait;
+        error = FX_THREAD_WAIT_IN_PROGRESS;
+    }
+
+    fx_sched_unlock(prev);
+
+    if (error == FX_THREAD_WAIT_IN_PROGRESS)
+    {
+        if (timeout != FX_THREAD_INFINITE_TIMEOUT)
+        {
+            fx_timer_internal_set_rel(&me->timer, timeout, 0);
+        }
+
+        error = fx_thread_wait_object_internal(
+            me, 
+            fx_internal_event_as_waitable(wake_event), 
+            NULL, 
+            NULL
+        );
+
+        fx_timer_internal_cancel(&me->timer);
+        fx_sched_lock(&prev);
+
+        if (me->notify_wait == NULL)
+        {
+            error = FX_THREAD_OK;
+        }
+        else
+        {
+            me->notify_wait = NULL;
+
+            if (error == FX_THREAD_OK)
+            {
+                error = FX_THREAD_WAIT_TIMEOUT;
+                trace_thread_timeout(&me->trace_handle, timeout);
+            }
+        }
+
+        fx_sched_unlock(prev);
+    }
+
+    return error;
+}
+
+//!
+//! Initializes notification state of the thread. 
+//! Called by thread constructor.
+//! @param [in,out] thread Thread being initialized.
+//!
+void
+fx_thread_notify_init(fx_thread_t* thread)
+{
+    thread->notify_value = 0;
+    thread->notify_wait = NULL;
+}
+
+//!
+//! Sends notification to the thread. If the thread is waiting for bits which
+//! are set after the action is performed, it is released.
+//! @param [in] thread Thread to be notified.
+//! @param [in] action Action to be performed on thread's notification value.
+//! @param [in] bits Argument of the action.
+//! @return FX_THREAD_OK in case of success, error code otherwise.
+//! @remark SPL <= DISPATCH.
+//!
+int 
+fx_thread_notify(
+    fx_thread_t* thread, 
+    fx_thread_notify_action_t action, 
+    uint32_t bits)
+{
+    fx_sched_state_t prev;
+
+    lang_param_assert(thread != NULL, FX_THREAD_INVALID_PTR);
+    lang_param_assert(
+        fx_rtp_check(&thread->rtp, FX_THREAD_MAGIC), 
+        FX_THREAD_INVALID_OBJ
+    );
+    lang_param_assert(
+        action < FX_THREAD_NOTIFY_ACTION_MAX, 
+        FX_THREAD_INVALID_PARAM
+    );
+
+    fx_sched_lock(&prev);
+
+    switch (action)
+    {
+    case FX_THREAD_NOTIFY_SET_BITS:
+        thread->notify_value |= bits;
+        break;
+    case FX_THREAD_NOTIFY_INCREMENT:
+        ++thread->notify_value;
+        break;
+    default:
+        thread->notify_value = bits;
+        break;
+    }
+
+    if (thread->notify_wait && 
+        fx_thread_notify_consume(thread, thread->notify_wait))
+    {
+        thread->notify_wait = NULL;
+        fx_event_internal_set(&thread->timer_event);
+    }
+
+    fx_sched_unlock(prev);
+    return FX_THREAD_OK;
+}
+
+//!
+//! Waits for notification. Wait is satisfied when any of bits specified by 
+//! the mask is set in notification value of calling thread. Bits specified
+//! by the mask are cleared when the wait is satisfied.
+//! @param [in] mask Bits to wait for. Use ~0 in order to wait for any nonzero 
+//! value.
+//! @param [in] timeout Timeout value. Use special value 
+//! FX_THREAD_INFINITE_TIMEOUT for infinite.
+//! @param [out] value Notification value before bits are cleared. Optional.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int 
+fx_thread_notify_wait(uint32_t mask, uint32_t timeout, uint32_t* value)
+{
+    fx_thread_notify_wait_t wait;
+    int error;
+
+    lang_param_assert(mask != 0, FX_THREAD_INVALID_PARAM);
+
+    wait.mask = mask;
+    wait.decrement = false;
+    wait.value = 0;
+    error = fx_thread_notify_wait_internal(&wait, timeout);
+
+    if (error == FX_THREAD_OK && value)
+    {
+        *value = wait.value;
+    }
+
+    return error;
+}
+
+//!
+//! Takes counting notification. Wait is satisfied when notification value of 
+//! calling thread is nonzero. The value is decremented by one (so, each 
+//! FX_THREAD_NOTIFY_INCREMENT notification satisfies one take), or cleared.
+//! @param [in] clear If true, the value is cleared instead of decrementing.
+//! @param [in] timeout Timeout value. Use special value 
+//! FX_THREAD_INFINITE_TIMEOUT for infinite.
+//! @param [out] value Notification value before it is consumed. Optional.
+//! @return Result of wait operation.
+//! @remark SPL = LOW.
+//!
+int 
+fx_thread_notify_take(bool clear, uint32_t timeout, uint32_t* value)
+{
+    fx_thread_notify_wait_t wait;
+    int error;
+
+    wait.mask = ~UINT32_C(0);
+    wait.decrement = !clear;
+    wait.value = 0;
+    error = fx_thread_notify_wait_internal(&wait, timeout);
+
+    if (error == FX_THREAD_OK && value)
+    {
+        *value = wait.value;
+    }
+
+    return error;
+}
@@ -0,0 +1,192 @@
+/** 
+  ******************************************************************************
+  *  @file   fx_thread_pi.c
+  *  @brief  Priority inheritance and ceiling support for threads.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(FX_THREAD)
+#include FX_INTERFACE(FX_DBG)
+
+FX_METADATA(({ implementation: [FX_THREAD, V1] }))
+
+//
+// Gets scheduling parameters which should be applied to the thread according
+// to its base priority and objects owned by the thread.
+// @remark SPL = SCHED_LEVEL
+//
+static void
+fx_thread_pi_get_params(fx_thread_t* thread, fx_sched_params_t* params)
+{
+    rtl_queue_t* const head = &thread->pi_objects;
+    rtl_queue_t* n = NULL;
+
+    fx_sched_params_copy(&thread->base_params, params);
+
+    for (n = rtl_queue_first(head); n != head; n = rtl_queue_next(n))
+    {
+        fx_thread_pi_t* const pi = rtl_queue_entry(n, fx_thread_pi_t, link);
+
+        if (pi->ceiling && fx_sched_params_is_preempt(pi->ceiling, params))
+        {
+            fx_sched_params_copy(pi->ceiling, params);
+        }
+
+        if (pi->waitable && _fx_sync_waitable_nonempty(pi->waitable))
+        {
+            fx_sync_wait_block_t* const wb = _fx_sync_wait_block_get(
+                pi->waitable,
+                FX_SYNC_POLICY_PRIO
+            );
+
+            if (fx_sched_params_is_preempt(wb->waiter->sched_params, params))
+            {
+                fx_sched_params_copy(wb->waiter->sched_params, params);
+            }
+        }
+    }
+}
+
+//!
+//! Initializes priority inheritance object.
+//! @param [in,out] pi Object to be initialized.
+//! @param [in] waitable Waitable whose waiters' priorities are inherited by the
+//! owner. NULL if priority inheritance is not used.
+//! @param [in] ceiling Ceiling priority. NULL if priority ceiling is not used.
+//!
+void
+fx_thread_pi_init(
+    fx_thread_pi_t* pi,
+    fx_sync_waitable_t* waitable,
+    const fx_sched_params_t* ceiling)
+{
+    rtl_queue_item_init(&pi->link);
+    pi->owner = NULL;
+    pi->waitable = waitable;
+    pi->ceiling = ceiling;
+}
+
+//!
+//! Recalculates priority of the thread. If the thread is blocked on the
+//! object with priority inheritance, changes are propagated to the owner of
+//! that object, and so on along the chain of owners.
+//! @param [in,out] thread Thread whose priority should be updated.
+//! @remark SPL = SCHED_LEVEL
+//!
+void
+fx_thread_pi_update(fx_thread_t* thread)
+{
+    while (thread != NULL)
+    {
+        fx_sched_params_t params;
+        fx_thread_pi_get_params(thread, &params);
+
+        if (fx_sched_params_is_equal(
+                &params, 
+                fx_thread_as_sched_params(thread)))
+        {
+            break;
+        }
+
+        //
+        // Scheduler avoids rescheduling when the current thread restores its
+        // own priority and no other changes were made since it was raised.
+        //
+        fx_thread_lock(thread);
+        fx_sched_item_set_params(fx_thread_as_sched_item(thread), &params);
+        fx_thread_unlock(thread);
+        fx_sync_waiter_params_changed(&thread->waiter);
+
+        thread = thread->pi_blocked_on ? thread->pi_blocked_on->owner : NULL;
+    }
+}
+
+//!
+//! Sets the owner of the object.
+//! @param [in,out] pi Object to be acquired.
+//! @param [in,out] owner New owner of the object.
+//! @remark SPL = SCHED_LEVEL
+//!
+void
+fx_thread_pi_acquire(fx_thread_pi_t* pi, fx_thread_t* owner)
+{
+    fx_dbg_assert(pi->owner == NULL);
+    pi->owner = owner;
+    rtl_enqueue(&owner->pi_objects, &pi->link);
+    fx_thread_pi_update(owner);
+}
+
+//!
+//! Resets the owner of the object. Priority of the previous owner is
+//! recalculated without the object.
+//! @param [in,out] pi Object to be released.
+//! @remark SPL = SCHED_LEVEL
+//!
+void
+fx_thread_pi_release(fx_thread_pi_t* pi)
+{
+    fx_thread_t* const owner = pi->owner;
+
+    if (owner)
+    {
+        rtl_queue_remove(&pi->link);
+        pi->owner = NULL;
+        fx_thread_pi_update(owner);
+    }
+}
+
+//!
+//! Marks the thread as blocked on the object. It should be called after the
+//! wait block is inserted into object's waitable. Owner of the object inherits
+//! priority of the thread.
+//! @param [in,out] thread Thread which is being blocked.
+//! @param [in] pi Object on which the thread waits.
+//! @remark SPL = SCHED_LEVEL
+//!
+void
+fx_thread_pi_block(fx_thread_t* thread, fx_thread_pi_t* pi)
+{
+    thread->pi_blocked_on = pi;
+    fx_thread_pi_update(pi->owner);
+}
+
+//!
+//! Resets blocked state of the thread. It should be called when the wait is
+//! completed (either successfully or not). If the wait was cancelled or timed
+//! out, owner of the object may lose priority inherited from the thread.
+//! @param [in,out] thread Thread whose wait is completed.
+//! @remark SPL = SCHED_LEVEL
+//!
+void
+fx_thread_pi_unblock(fx_thread_t* thread)
+{
+    fx_thread_pi_t* const pi = thread->pi_blocked_on;
+
+    if (pi)
+    {
+        thread->pi_blocked_on = NULL;
+        fx_thread_pi_update(pi->owner);
+    }
+}
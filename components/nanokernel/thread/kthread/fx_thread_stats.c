@@ -0,0 +1,191 @@
+/** 
+  ******************************************************************************
+  *  @file   fx_thread_stats.c
+  *  @brief  Accounting of CPU time consumed by threads.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(FX_THREAD)
+#include FX_INTERFACE(HAL_MP)
+
+FX_METADATA(({ implementation: [FX_THREAD, V1] }))
+
+#if defined FX_THREAD_CPU_STATS
+
+#define fx_thread_is_valid(thr) (fx_rtp_check((&((thr)->rtp)), FX_THREAD_MAGIC))
+
+//
+// Per-CPU accounting state. Run time of the current thread is measured from 
+// the last context switch (run stamp), interrupt time is measured from the 
+// entry of the outermost ISR (interrupt stamp). When the ISR completes, run 
+// stamp is advanced by its duration, so, interrupt time is not charged as 
+// thread's run time.
+// Interrupt hooks may be called from nested ISRs and the dispatcher may run 
+// below ISR level (in segmented SPL scheme), so, the state is always modified
+// at SYNC level.
+//
+typedef struct
+{
+    uint32_t run_stamp;
+    uint32_t intr_stamp;
+    unsigned int intr_nesting;
+}
+fx_thread_stats_context_t;
+
+static fx_thread_stats_context_t g_thread_stats[HAL_MP_CPU_MAX];
+
+//!
+//! Starts cycle counter of current processor. Called by thread module 
+//! constructor.
+//!
+void
+fx_thread_stats_ctor(void)
+{
+    fx_thread_stats_context_t* const context = 
+        &g_thread_stats[hal_mp_get_current_cpu()];
+
+    hal_clock_cycles_init();
+    context->run_stamp = hal_clock_get_cycles();
+    context->intr_nesting = 0;
+}
+
+//!
+//! Resets thread statistics.
+//! @param [in] thread Thread to be initialized.
+//!
+void
+fx_thread_stats_init(fx_thread_t* thread)
+{
+    thread->stats.run_cycles = 0;
+    thread->stats.intr_cycles = 0;
+}
+
+//!
+//! Charges cycles elapsed since the previous context switch to the outgoing
+//! thread. Called by the dispatcher.
+//! @param [in] prev Thread being switched out.
+//! @remark SPL = SCHED_LEVEL
+//!
+void
+fx_thread_stats_switch(fx_thread_t* prev)
+{
+    fx_thread_stats_context_t* const context = 
+        &g_thread_stats[hal_mp_get_current_cpu()];
+    uint32_t now;
+    spl_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+    now = hal_clock_get_cycles();
+    prev->stats.run_cycles += now - context->run_stamp;
+    context->run_stamp = now;
+    fx_spl_lower_to_any_from_sync(state);
+}
+
+//!
+//! Marks ISR entry. It is called by HAL for interrupts handled by the kernel
+//! (including tick interrupt). Application ISRs installed directly into 
+//! vector table must call this function at entry and fx_thread_intr_exit at 
+//! exit, otherwise their time is charged to interrupted thread. Nested calls
+//! are allowed.
+//! @remark SPL <= SYNC. ISRs with priority above SYNC level must not call it.
+//!
+void
+fx_thread_intr_enter(void)
+{
+    fx_thread_stats_context_t* const context = 
+        &g_thread_stats[hal_mp_get_current_cpu()];
+    spl_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+
+    if (context->intr_nesting++ == 0)
+    {
+        context->intr_stamp = hal_clock_get_cycles();
+    }
+
+    fx_spl_lower_to_any_from_sync(state);
+}
+
+//!
+//! Marks ISR exit. Time spent in the outermost ISR is charged to interrupted
+//! thread.
+//! @remark SPL <= SYNC. ISRs with priority above SYNC level must not call it.
+//!
+void
+fx_thread_intr_exit(void)
+{
+    fx_thread_stats_context_t* const context = 
+        &g_thread_stats[hal_mp_get_current_cpu()];
+    spl_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+
+    if (--context->intr_nesting == 0)
+    {
+        const uint32_t spent = hal_clock_get_cycles() - context->intr_stamp;
+        fx_thread_t* const me = fx_thread_self();
+
+        me->stats.intr_cycles += spent;
+        context->run_stamp += spent;
+    }
+
+    fx_spl_lower_to_any_from_sync(state);
+}
+
+//!
+//! Gets CPU time statistics of the thread. If the thread is running, cycles
+//! elapsed since the last context switch are included.
+//! @param [in] thread Thread to get statistics from.
+//! @param [out] stats Pointer to statistics structure to be filled.
+//! @return FX_THREAD_OK in case of success, error code otherwise.
+//!
+int
+fx_thread_get_stats(fx_thread_t* thread, fx_thread_stats_t* stats)
+{
+    fx_thread_t* const me = fx_thread_self();
+    fx_sched_state_t prev;
+    spl_t state;
+    lang_param_assert(thread != NULL, FX_THREAD_INVALID_PTR);
+    lang_param_assert(stats != NULL, FX_THREAD_INVALID_PTR);
+    lang_param_assert(fx_thread_is_valid(thread), FX_THREAD_INVALID_OBJ);
+
+    fx_sched_lock(&prev);
+    fx_spl_raise_to_sync_from_any(&state);
+    *stats = thread->stats;
+
+    if (thread == me)
+    {
+        const fx_thread_stats_context_t* const context = 
+            &g_thread_stats[hal_mp_get_current_cpu()];
+
+        stats->run_cycles += hal_clock_get_cycles() - context->run_stamp;
+    }
+
+    fx_spl_lower_to_any_from_sync(state);
+    fx_sched_unlock(prev);
+    return FX_THREAD_OK;
+}
+
+#endif
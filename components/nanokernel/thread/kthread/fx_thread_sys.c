@@ -171,6 +171,7 @@ fx_thread_ctor(void)
     fx_sched_item_resume(&idle_thread->sched_item);
     fx_stackovf_init(&idle_thread->stk_info, NULL, 0); 
     fx_thread_apc_target_init(&idle_thread->apcs);
+    fx_thread_stats_init(idle_thread);
     fx_thread_timeslice_ctor(
         &context->timeslicing_context, 
         fx_thread_quanta_expired, 
@@ -183,8 +184,11 @@ fx_thread_ctor(void)
     {
         fx_process_set_exception(FX_EXCEPTION_TERM,fx_thread_term_handler,NULL);
         fx_thread_apc_ctor(&idle_thread->apcs,fx_thread_apc_on_receive_handler);
+        fx_thread_addr_ctor();
     }
 
+    fx_thread_stats_ctor();
+
     fx_app_timer_ctor();
 }
 
@@ -232,6 +236,7 @@ fx_dispatch_handler(void)
 
         if (next != prev)
         {
+            fx_thread_stats_switch(prev);
             g_current_thread[cpu] = next;
             
             trace_thread_context_switch(
@@ -262,6 +267,24 @@ fx_dispatch_handler(void)
     fx_sched_unlock_from_disp_spl(prev_state);
 }  
 
+#if defined FX_THREAD_CPU_STATS
+
+//!
+//! Gets CPU time statistics of the idle thread of current processor.
+//! @param [out] stats Pointer to statistics structure to be filled.
+//! @return FX_THREAD_OK in case of success, error code otherwise.
+//!
+int
+fx_thread_get_idle_stats(fx_thread_stats_t* stats)
+{
+    fx_thread_context_t* const context = 
+        &g_thread_context[hal_mp_get_current_cpu()];
+
+    return fx_thread_get_stats(&context->idle_thread, stats);
+}
+
+#endif
+
 //!
 //! This function is called by HAL in context of thread causing the exception.
 //!
@@ -86,6 +86,55 @@ fx_sync_waiter_notify(fx_sync_waiter_t* self)
     trace_thread_resume(&thread->trace_handle);
 }
 
+//
+// Suspends the thread which has started a wait and waits for notification.
+// Scheduler is unlocked while the thread is suspended.
+// @remark SPL = SCHED_LEVEL
+//
+static void
+fx_thread_wait_suspend(fx_thread_t* me, fx_sched_state_t* prev)
+{
+    //
+    // Suspend thread. Because we're on SCHED_LEVEL level now, this thread 
+    // continues execution.
+    //
+    fx_thread_lock(me);
+    fx_sched_item_suspend(&me->sched_item);
+    me->state = FX_THREAD_STATE_WAITING;
+    fx_thread_unlock(me);
+
+    //
+    // Since waiter may receive notification callbacks (on SMP system) just 
+    // after test&wait function is called, if notification is performed
+    // on another CPU before "suspend", then notification will be missed 
+    // (by specification resume function should not perform any actions if 
+    // sched item is already in running state). In case when resume is 
+    // missed (waiter already satisfied) we should do resume manually in 
+    // order to prevent infinite sleep. If notification will be received 
+    // between checking and resuming, then this resume will be skipped 
+    // because thread will be already in running state.
+    //
+    if (fx_sync_is_waiter_satisfied(&me->waiter) || 
+        fx_thread_apc_pending(&me->apcs))
+    {
+        fx_thread_lock(me);
+        fx_sched_item_resume(&me->sched_item);
+        me->state = FX_THREAD_STATE_READY;
+        fx_thread_unlock(me);
+    }
+
+    //
+    // Request rescheduling (wait preemption point).
+    //
+    fx_sched_unlock(*prev);
+
+    //
+    // We come here when thread woken up by some reason.
+    //
+    fx_sched_lock(prev);
+    trace_thread_wakeup(&me->trace_handle);
+}
+
 //!
 //! Suspends current thread until waitable object is signaled. Wait operation 
 //! may be cancelled by setting abort event.
@@ -147,45 +196,7 @@ fx_thread_wait_object_internal(
     //
     if (wait_skip == FX_THREAD_WAIT_IN_PROGRESS)
     {
-        //
-        // Suspend thread. Because we're on SCHED_LEVEL level now, this thread 
-        // continues execution.
-        //
-        fx_thread_lock(me);
-        fx_sched_item_suspend(&me->sched_item);
-        me->state = FX_THREAD_STATE_WAITING;
-        fx_thread_unlock(me);
-
-        //
-        // Since waiter may receive notification callbacks (on SMP system) just 
-        // after test&wait function is called, if notification is performed
-        // on another CPU before "suspend", then notification will be missed 
-        // (by specification resume function should not perform any actions if 
-        // sched item is already in running state). In case when resume is 
-        // missed (waiter already satisfied) we should do resume manually in 
-        // order to prevent infinite sleep. If notification will be received 
-        // between checking and resuming, then this resume will be skipped 
-        // because thread will be already in running state.
-        //
-        if (fx_sync_is_waiter_satisfied(&me->waiter) || 
-            fx_thread_apc_pending(&me->apcs))
-        {
-            fx_thread_lock(me);
-            fx_sched_item_resume(&me->sched_item);
-            me->state = FX_THREAD_STATE_READY;
-            fx_thread_unlock(me);
-        }
-
-        //
-        // Request rescheduling (wait preemption point).
-        //
-        fx_sched_unlock(prev);
-
-        //
-        // We come here when thread woken up by some reason.
-        //
-        fx_sched_lock(&prev);
-        trace_thread_wakeup(&me->trace_handle);
+        fx_thread_wait_suspend(me, &prev);
     }
 
     //
@@ -193,6 +204,7 @@ fx_thread_wait_object_internal(
     // waitable object's queue. 
     //
     rolled_back_wb_num = fx_sync_wait_rollback(&me->waiter);
+
     fx_sched_unlock(prev);
     main_obj_status = fx_sync_wait_block_get_status(&(wb[0]));
     cancel_ev_status = fx_sync_wait_block_get_status(&(wb[1]));
@@ -339,3 +351,258 @@ fx_thread_timedwait_event(fx_event_t* event, uint32_t timeout)
         NULL, timeout
     );
 }
+
+//
+// Calculation of multiple wait status by statuses of wait blocks.
+// @param [in] wb Wait blocks of objects (followed by timeout event block).
+// @param [in] n Number of objects.
+// @param [in] expected Number of objects which must be signaled.
+// @param [in] timed Timeout block presence flag.
+// @param [out] index Index of the first signaled object (or deleted object).
+// @return Wait status.
+//
+static int 
+fx_thread_get_multiple_status(
+    fx_sync_wait_block_t* wb, 
+    unsigned int n, 
+    unsigned int expected, 
+    bool timed, 
+    unsigned int* index)
+{
+    unsigned int satisfied = 0;
+    unsigned int deleted = n;
+    unsigned int i = 0;
+
+    for (i = 0; i < n; ++i)
+    {
+        const fx_wait_status_t status = fx_sync_wait_block_get_status(&wb[i]);
+
+        if (status == FX_WAIT_SATISFIED)
+        {
+            if (satisfied++ == 0)
+            {
+                *index = i;
+            }
+        }
+        else if (status == FX_WAIT_DELETED && deleted == n)
+        {
+            deleted = i;
+        }
+    }
+
+    if (satisfied >= expected)
+    {
+        return FX_STATUS_OK;
+    }
+
+    if (timed && fx_sync_wait_block_get_status(&wb[n]) == FX_WAIT_SATISFIED)
+    {
+        return FX_THREAD_WAIT_TIMEOUT;
+    }
+
+    if (deleted != n)
+    {
+        *index = deleted;
+        return FX_THREAD_WAIT_DELETED;
+    }
+
+    return FX_THREAD_WAIT_INTERRUPTED;
+}
+
+//!
+//! Suspends current thread until any or all of waitable objects are signaled
+//! or timeout is exceeded. 
+//! @param [in] objects Array of objects to wait for (with their attributes).
+//! @param [in] n Number of objects. It must not exceed 
+//! FX_THREAD_WAIT_MULTIPLE_MAX.
+//! @param [in] mode Wait mode: FX_THREAD_WAIT_ANY or FX_THREAD_WAIT_ALL.
+//! @param [in] timeout Timeout value. Use special value 
+//! FX_THREAD_INFINITE_TIMEOUT for infinite.
+//! @param [out] index Index of the object which satisfied the wait (first one 
+//! in ALL mode) or index of deleted object if FX_THREAD_WAIT_DELETED is 
+//! returned. Optional (may be NULL).
+//! @return Result of wait operation. 
+//! @remark SPL = LOW. Each object must be specified only once. If timeout 
+//! value is 0, the function only tests objects and never blocks. In ALL mode 
+//! objects are acquired independently as they become signaled and there is no 
+//! way to return consumed state back if the wait fails, so, only events are 
+//! accepted in ALL mode (FX_THREAD_INVALID_OBJ is returned for other objects).
+//! Thread has single link to the object it inherits priority through, so, it 
+//! may be blocked on only one object with priority inheritance (i.e. busy 
+//! mutex). If the thread would be blocked on more than one such object, the 
+//! wait is rolled back and FX_THREAD_INVALID_OBJ is returned.
+//!
+int 
+fx_thread_wait_multiple(
+    const fx_thread_wait_item_t* objects, 
+    unsigned int n, 
+    fx_thread_wait_mode_t mode, 
+    uint32_t timeout, 
+    unsigned int* index)
+{
+    fx_thread_t* const me = fx_thread_self();
+    fx_event_internal_t* const cancel_ev = &me->timer_event;
+    const bool timed = (timeout != 0 && timeout != FX_THREAD_INFINITE_TIMEOUT);
+    const unsigned int expected = (mode == FX_THREAD_WAIT_ALL) ? n : 1;
+    const bool wait = (timeout != 0);
+    unsigned int signaled = 0;
+    unsigned int rolled_back_wb_num;
+    unsigned int i = 0;
+    int wait_skip = FX_THREAD_WAIT_IN_PROGRESS;
+    int error;
+    fx_sync_wait_block_t wb[FX_THREAD_WAIT_MULTIPLE_MAX + 1];
+    fx_thread_pi_t* pi[FX_THREAD_WAIT_MULTIPLE_MAX];
+    fx_thread_pi_t* blocked_on = NULL;
+    fx_sched_state_t prev;
+
+    lang_param_assert(objects != NULL, FX_THREAD_INVALID_PTR);
+    lang_param_assert(
+        n > 0 && n <= FX_THREAD_WAIT_MULTIPLE_MAX, 
+        FX_THREAD_INVALID_PARAM
+    );
+    lang_param_assert(mode < FX_THREAD_WAIT_MODE_MAX, FX_THREAD_INVALID_PARAM);
+    lang_param_assert(
+        timeout < FX_TIMER_MAX_RELATIVE_TIMEOUT || 
+            timeout == FX_THREAD_INFINITE_TIMEOUT, 
+        FX_THREAD_INVALID_TIMEOUT
+    );
+
+    for (i = 0; i < n; ++i)
+    {
+        const fx_sync_wait_block_t init = FX_SYNC_WAIT_BLOCK_INITIALIZER(
+            &me->waiter, 
+            objects[i].object, 
+            objects[i].attr
+        );
+
+        lang_param_assert(objects[i].object != NULL, FX_THREAD_INVALID_OBJ);
+        lang_param_assert(
+            mode != FX_THREAD_WAIT_ALL || 
+                objects[i].object->test_wait == fx_event_test_and_wait,
+            FX_THREAD_INVALID_OBJ
+        );
+        wb[i] = init;
+        pi[i] = NULL;
+    }
+
+    //
+    // Timeout is implemented by additional wait block of the timer event. It
+    // resides beyond expected wait blocks, so, it satisfies the wait in any 
+    // mode.
+    //
+    if (timed)
+    {
+        const fx_sync_wait_block_t init = FX_SYNC_WAIT_BLOCK_INITIALIZER(
+            &me->waiter, 
+            fx_internal_event_as_waitable(cancel_ev), 
+            NULL
+        );
+
+        wb[n] = init;
+        fx_event_internal_reset(cancel_ev);
+        fx_timer_internal_set_rel(&me->timer, timeout, 0);
+    }
+
+    fx_sync_waiter_prepare(&me->waiter, wb, timed ? n + 1 : n, expected);
+    fx_sched_lock(&prev);
+
+    //
+    // Test all objects. Signaled objects are accounted as satisfied wait 
+    // blocks, others are linked to objects' queues (unless timeout is 0). In 
+    // ANY mode testing is stopped at first signaled object. Objects with 
+    // priority inheritance mark the thread as blocked on them, these marks 
+    // are remembered in order to revert inherited priority on rollback. 
+    // Priority changes of the thread are propagated only to the last object 
+    // it is blocked on, so, blocking on the second one fails the wait.
+    //
+    for (i = 0; i < n && wait_skip == FX_THREAD_WAIT_IN_PROGRESS; ++i)
+    {
+        fx_sync_waitable_t* const object = objects[i].object;
+        const bool satisfied = object->test_wait(object, &wb[i], wait);
+
+        if (me->pi_blocked_on != blocked_on)
+        {
+            if (blocked_on != NULL)
+            {
+                wait_skip = FX_THREAD_INVALID_OBJ;
+            }
+
+            pi[i] = blocked_on = me->pi_blocked_on;
+        }
+
+        if (wait_skip == FX_THREAD_WAIT_IN_PROGRESS && satisfied && 
+            fx_sync_waiter_satisfy(&me->waiter, &wb[i]))
+        {
+            wait_skip = FX_STATUS_OK;
+            signaled = (mode == FX_THREAD_WAIT_ALL) ? 0 : i;
+        }
+    }
+
+    if (wait_skip == FX_THREAD_WAIT_IN_PROGRESS)
+    {
+        if (timeout == 0)
+        {
+            wait_skip = FX_THREAD_WAIT_TIMEOUT;
+        }
+        else if (timed && fx_event_test_and_wait(
+                    fx_internal_event_as_waitable(cancel_ev), 
+                    &wb[n], 
+                    true))
+        {
+            wait_skip = FX_THREAD_WAIT_TIMEOUT;
+        }
+        else
+        {
+            fx_thread_wait_suspend(me, &prev);
+        }
+    }
+
+    rolled_back_wb_num = fx_sync_wait_rollback(&me->waiter);
+
+    //
+    // Owners of objects which did not satisfy the wait may lose priority 
+    // inherited from this thread. Wait blocks are already removed from the 
+    // queues, so, owner's priority is recalculated without the thread. 
+    // Deleted objects are skipped since they must not be accessed.
+    //
+    me->pi_blocked_on = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        const fx_wait_status_t status = fx_sync_wait_block_get_status(&wb[i]);
+
+        if (pi[i] && status != FX_WAIT_SATISFIED && status != FX_WAIT_DELETED)
+        {
+            fx_thread_pi_update(pi[i]->owner);
+        }
+    }
+
+    fx_sched_unlock(prev);
+
+    if (timed)
+    {
+        fx_timer_internal_cancel(&me->timer);
+    }
+
+    //
+    // If no wait blocks were rolled back it means that the wait was 
+    // interrupted by APC (which has already performed rollback).
+    //
+    error = wait_skip == FX_THREAD_WAIT_IN_PROGRESS ? 
+        rolled_back_wb_num ? 
+            fx_thread_get_multiple_status(wb, n, expected, timed, &signaled):
+            FX_THREAD_WAIT_INTERRUPTED:
+        wait_skip;
+
+    if (error == FX_THREAD_WAIT_TIMEOUT)
+    {
+        trace_thread_timeout(&me->trace_handle, timeout);
+    }
+
+    if (index)
+    {
+        *index = signaled;
+    }
+
+    return error;
+}
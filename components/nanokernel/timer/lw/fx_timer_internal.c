@@ -32,18 +32,19 @@
 #include FX_INTERFACE(TRACE_CORE)
 #include FX_INTERFACE(FX_DBG)
 #include FX_INTERFACE(FX_SPL)
+#include FX_INTERFACE(FX_DPC)
 #include FX_INTERFACE(HAL_MP)
 
 FX_METADATA(({ implementation: [FX_TIMER_INTERNAL, SIMPLE] }))
 
 //
-// Simple timers may only be used with unified sync scheme on single-CPU systems
+// Simple timers may only be used on single-CPU systems.
 //
-lang_static_assert(FX_SPL_SCHED_LEVEL == SPL_SYNC);
 lang_static_assert(HAL_MP_CPU_MAX == 1);
 
 static rtl_list_t fx_timer_internal_timers;
 static volatile uint32_t fx_timer_internal_ticks = 0;
+static fx_dpc_t fx_timer_internal_dpc;
 
 //!
 //! Timer module initialization.
@@ -53,6 +54,8 @@ void
 fx_timer_ctor(void)
 {
     rtl_list_init(&(fx_timer_internal_timers));
+    fx_dpc_init(&fx_timer_internal_dpc);
+    fx_dpc_set_importance(&fx_timer_internal_dpc, FX_DPC_IMPORTANCE_HIGH);
 }
 
 //!
@@ -199,17 +202,67 @@ fx_timer_internal_set_rel(
 }
 
 //!
-//! Tick handler is called by the HAL.
+//! Gets number of ticks which may elapse without expiration of any timer.
+//! It is used by the HAL in tickless mode to program the hardware timer.
+//! @param [in] max Maximum number of ticks which may be skipped by hardware.
+//! @return Number of ticks which may be skipped (it does not exceed max).
 //!
-void 
-fx_tick_handler(void)
+uint32_t
+fx_tick_get_idle(uint32_t max)
 {
     rtl_list_t* list = &(fx_timer_internal_timers);
+    uint32_t idle = max;
     fx_lock_intr_state_t state;
 
     fx_spl_raise_to_sync_from_any(&state);
-    ++fx_timer_internal_ticks;
+
+    if (!rtl_list_empty(list))
+    {
+        fx_timer_internal_t* item = rtl_list_entry(
+            rtl_list_first(list), 
+            fx_timer_internal_t, 
+            link
+        );
+
+        const int32_t delta = 
+            (int32_t)(item->timeout - fx_timer_internal_ticks);
+
+        idle = (delta > 1) ? lang_min((uint32_t) delta - 1, max) : 0;
+    }
+
+    fx_spl_lower_to_any_from_sync(state);
+    return idle;
+}
+
+//!
+//! Credits ticks skipped during tickless idle to the tick counter in one step.
+//! @param [in] ticks Number of elapsed ticks. It must not exceed value 
+//! returned by preceding call to fx_tick_get_idle, so no timers may expire.
+//!
+void 
+fx_tick_advance(uint32_t ticks)
+{
+    fx_lock_intr_state_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+    fx_timer_internal_ticks += ticks;
     trace_increment_tick(fx_timer_internal_ticks);
+    fx_spl_lower_to_any_from_sync(state);
+}
+
+//
+// Timer DPC. It handles all timers expired by the current tick. In case when 
+// DPC is requested multiple times before handling, it is queued only once,
+// but all expired timers are processed anyway.
+// @remark SPL = DISPATCH
+//
+static void
+fx_timer_internal_dpc_handler(fx_dpc_t* dpc, void* arg)
+{
+    rtl_list_t* list = &(fx_timer_internal_timers);
+    fx_lock_intr_state_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
 
     while (!rtl_list_empty(list))
     {
@@ -239,3 +292,24 @@ fx_tick_handler(void)
 
     fx_spl_lower_to_any_from_sync(state);
 }
+
+//!
+//! Tick handler is called by the HAL.
+//! It only increments tick counter, timers are handled by the DPC.
+//!
+void 
+fx_tick_handler(void)
+{
+    fx_lock_intr_state_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+    ++fx_timer_internal_ticks;
+    trace_increment_tick(fx_timer_internal_ticks);
+    fx_spl_lower_to_any_from_sync(state);
+
+    (void) fx_dpc_request(
+        &fx_timer_internal_dpc, 
+        fx_timer_internal_dpc_handler, 
+        NULL
+    );
+}
@@ -5,8 +5,8 @@
   ******************************************************************************
   *  @file   fx_timer_internal.h
   *  @brief  Internal timers interface. This implementation may be used ONLY in 
-  *  uniprocessor systems with unified interrupt architecture since timer 
-  *  callback may be called from interrupt handlers directly.
+  *  uniprocessor systems. Timer callbacks are called from the DPC requested by
+  *  tick interrupt handler (directly from the handler when DPC stub is used).
   ******************************************************************************
   *  Copyright (C) JSC EREMEX, 2008-2020.
   *  Redistribution and use in source and binary forms, with or without 
@@ -80,6 +80,8 @@ int fx_timer_internal_set_abs(
     uint32_t delay, 
     uint32_t period
 );
+uint32_t fx_tick_get_idle(uint32_t max);
+void fx_tick_advance(uint32_t ticks);
 
 FX_METADATA(({ interface: [FX_TIMER_INTERNAL, SIMPLE] }))
 
@@ -0,0 +1,472 @@
+/** 
+  ******************************************************************************
+  *  @file   fx_timer_internal.c
+  *  @brief  Uniprocessor timers based on hierarchical timing wheel.
+  *  Timer arming and cancellation take constant time regardless of number of
+  *  active timers.
+  ******************************************************************************
+  *  Copyright (C) JSC EREMEX, 2008-2020.
+  *  Redistribution and use in source and binary forms, with or without 
+  *  modification, are permitted provided that the following conditions are met:
+  *  1. Redistributions of source code must retain the above copyright notice,
+  *     this list of conditions and the following disclaimer.
+  *  2. Redistributions in binary form must reproduce the above copyright 
+  *     notice, this list of conditions and the following disclaimer in the 
+  *     documentation and/or other materials provided with the distribution.
+  *  3. Neither the name of the copyright holder nor the names of its 
+  *     contributors may be used to endorse or promote products derived from 
+  *     this software without specific prior written permission.
+  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+  *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+  *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE 
+  *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+  *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+  *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+  *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+  *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  *  POSSIBILITY OF SUCH DAMAGE.
+  *****************************************************************************/
+
+#include FX_INTERFACE(FX_TIMER_INTERNAL)
+#include FX_INTERFACE(TRACE_CORE)
+#include FX_INTERFACE(FX_DBG)
+#include FX_INTERFACE(FX_SPL)
+#include FX_INTERFACE(FX_DPC)
+#include FX_INTERFACE(HAL_MP)
+
+FX_METADATA(({ implementation: [FX_TIMER_INTERNAL, WHEEL] }))
+
+//
+// Wheel timers may only be used on single-CPU systems.
+//
+lang_static_assert(HAL_MP_CPU_MAX == 1);
+
+//
+// Timers are distributed across levels of the wheel depending on the distance
+// between their deadline and current tick. Level 0 contains timers expiring
+// within next 2^N ticks, one slot per tick. Each slot at level L covers
+// 2^(N*L) ticks. When low N*L bits of the tick counter wrap to zero the
+// corresponding slot of level L is cascaded, i.e. its timers are redistributed
+// into lower levels. So, each timer is moved at most (LEVELS - 1) times during
+// its lifetime and each tick processes at most one slot at each level.
+//
+#define FX_TIMER_WHEEL_MASK (FX_TIMER_WHEEL_SLOTS - 1)
+#define fx_timer_wheel_index(t, level) \
+    (((t) >> ((level) * FX_TIMER_WHEEL_SLOT_BITS)) & FX_TIMER_WHEEL_MASK)
+
+static rtl_list_t fx_timer_wheel[FX_TIMER_WHEEL_LEVELS][FX_TIMER_WHEEL_SLOTS];
+static volatile uint32_t fx_timer_internal_ticks = 0;
+
+//
+// Ticks counted by the interrupt handler but not yet processed by the DPC.
+// Wheel position is advanced one tick at a time, so, tick counter visible to
+// the user is the sum of wheel position and pending ticks.
+//
+static volatile uint32_t fx_timer_wheel_pending = 0;
+static fx_dpc_t fx_timer_wheel_dpc;
+
+//!
+//! Timer module initialization.
+//! @remark SPL = SYNC
+//!
+void
+fx_timer_ctor(void)
+{
+    unsigned int level, slot;
+
+    for (level = 0; level < FX_TIMER_WHEEL_LEVELS; ++level)
+    {
+        for (slot = 0; slot < FX_TIMER_WHEEL_SLOTS; ++slot)
+        {
+            rtl_list_init(&(fx_timer_wheel[level][slot]));
+        }
+    }
+
+    fx_dpc_init(&fx_timer_wheel_dpc);
+    fx_dpc_set_importance(&fx_timer_wheel_dpc, FX_DPC_IMPORTANCE_HIGH);
+}
+
+//
+// Helper function for timer insertion. It has O(1) latency.
+// Timers which are expired relative to base tick are inserted as if they
+// expire at base tick.
+// @remark SPL = SYNC
+//
+static void
+_fx_timer_insert(fx_timer_internal_t* timer, uint32_t base)
+{
+    uint32_t expires = timer->timeout;
+    uint32_t delta;
+    unsigned int level = 0;
+    rtl_list_t* slot;
+
+    if ((int32_t)(expires - base) < 0)
+    {
+        expires = base;
+    }
+
+    delta = expires - fx_timer_internal_ticks;
+
+    while (level < (FX_TIMER_WHEEL_LEVELS - 1) &&
+        (delta >> (level * FX_TIMER_WHEEL_SLOT_BITS)) >= FX_TIMER_WHEEL_SLOTS)
+    {
+        ++level;
+    }
+
+    slot = &fx_timer_wheel[level][fx_timer_wheel_index(expires, level)];
+    rtl_list_insert(rtl_list_last(slot), &timer->link);
+}
+
+//
+// Moves all timers from specified slot into lower levels of the wheel.
+// Timers are detached from the slot before redistribution in order to avoid
+// reinsertion into the same slot. Interrupts are enabled for a short period
+// after each timer to bound the interrupt latency.
+// @remark SPL = SYNC
+//
+static void
+_fx_timer_cascade(unsigned int level, fx_lock_intr_state_t* state)
+{
+    rtl_list_t* slot = &fx_timer_wheel[level][
+        fx_timer_wheel_index(fx_timer_internal_ticks, level)
+    ];
+    rtl_list_t pending;
+
+    if (rtl_list_empty(slot))
+    {
+        return;
+    }
+
+    rtl_list_init(&pending);
+    rtl_list_insert_range(&pending, slot);
+    rtl_list_init(slot);
+
+    while (!rtl_list_empty(&pending))
+    {
+        fx_timer_internal_t* item = rtl_list_entry(
+            rtl_list_first(&pending),
+            fx_timer_internal_t,
+            link
+        );
+
+        rtl_list_remove(&item->link);
+        _fx_timer_insert(item, fx_timer_internal_ticks);
+
+        fx_spl_lower_to_any_from_sync(*state);
+        fx_spl_raise_to_sync_from_any(state);
+    }
+}
+
+//!
+//! Read tick counter.
+//! Since tick counter is 32-bit, reads may not be atomic on 16-bit CPUs, so,
+//! read counter with interrupts disabled.
+//! @return current value of tick counter.
+//!
+uint32_t
+fx_timer_get_tick_count(void)
+{
+    uint32_t ticks;
+    fx_lock_intr_state_t state;
+    fx_spl_raise_to_sync_from_any(&state);
+    ticks = fx_timer_internal_ticks + fx_timer_wheel_pending;
+    fx_spl_lower_to_any_from_sync(state);
+    return ticks;
+}
+
+//!
+//! Sets tick counter.
+//! Position of each active timer in the wheel depends on the tick counter, so,
+//! all active timers are redistributed relative to the new value. This takes
+//! O(n) time with interrupts disabled. Pending ticks are considered as 
+//! processed ones, so, all overdue timers expire at the next tick.
+//! @return Old value of tick counter.
+//!
+uint32_t
+fx_timer_set_tick_count(uint32_t newticks)
+{
+    uint32_t ticks;
+    unsigned int level, slot;
+    rtl_list_t pending;
+    fx_lock_intr_state_t state;
+
+    rtl_list_init(&pending);
+    fx_spl_raise_to_sync_from_any(&state);
+    ticks = fx_timer_internal_ticks + fx_timer_wheel_pending;
+    fx_timer_internal_ticks = newticks;
+    fx_timer_wheel_pending = 0;
+
+    for (level = 0; level < FX_TIMER_WHEEL_LEVELS; ++level)
+    {
+        for (slot = 0; slot < FX_TIMER_WHEEL_SLOTS; ++slot)
+        {
+            rtl_list_t* head = &(fx_timer_wheel[level][slot]);
+
+            if (!rtl_list_empty(head))
+            {
+                rtl_list_insert_range(&pending, head);
+                rtl_list_init(head);
+            }
+        }
+    }
+
+    while (!rtl_list_empty(&pending))
+    {
+        fx_timer_internal_t* item = rtl_list_entry(
+            rtl_list_first(&pending),
+            fx_timer_internal_t,
+            link
+        );
+
+        rtl_list_remove(&item->link);
+        _fx_timer_insert(item, newticks + 1);
+    }
+
+    fx_spl_lower_to_any_from_sync(state);
+    return ticks;
+}
+
+//!
+//! Timer constructor.
+//! Initializes timer object.
+//! @param [in,out] timer Timer object to be initialized (allocated by user).
+//! @param [in] func Callback function.
+//! @param [in] arg Callback argument.
+//! @return FX_TIMER_OK if succeeded, error code otherwise.
+//!
+int
+fx_timer_internal_init(fx_timer_internal_t* timer, int (*fn)(void*), void* arg)
+{
+    timer->callback = fn;
+    timer->callback_arg = arg;
+    return FX_TIMER_OK;
+}
+
+//!
+//! Cancels timer.
+//! If timer was inactive, no actions will be performed.
+//! @param [in] timer Timer object to be cancelled.
+//! @return FX_TIMER_OK in case of success, error code otherwise.
+//!
+int
+fx_timer_internal_cancel(fx_timer_internal_t* timer)
+{
+    int error = FX_TIMER_ALREADY_CANCELLED;
+    fx_lock_intr_state_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+    if (rtl_list_is_node_linked(&timer->link))
+    {
+        rtl_list_remove(&timer->link);
+        error = FX_TIMER_OK;
+    }
+    fx_spl_lower_to_any_from_sync(state);
+    return error;
+}
+
+//!
+//! Sets timeout for timer with specified absolute tick value.
+//! @param [in] timer Timer object to be armed.
+//! @param [in] delay Absolute timeout value in ticks.
+//! @param [in] period Period for periodic timers. 0 for one-shot timers.
+//! @return FX_TIMER_OK in case of success, error code otherwise.
+//!
+int
+fx_timer_internal_set_abs(
+    fx_timer_internal_t* timer,
+    uint32_t delay,
+    uint32_t period)
+{
+    fx_lock_intr_state_t state;
+    fx_spl_raise_to_sync_from_any(&state);
+
+    if (rtl_list_is_node_linked(&timer->link))
+    {
+        rtl_list_remove(&timer->link);
+    }
+
+    timer->timeout = delay;
+    timer->period = period;
+    _fx_timer_insert(timer, fx_timer_internal_ticks + 1);
+    fx_spl_lower_to_any_from_sync(state);
+    return FX_TIMER_OK;
+}
+
+//!
+//! Sets timeout for timer with specified relative tick value.
+//! @param [in] timer Timer object to be armed.
+//! @param [in] delay Relative timeout value in ticks.
+//! @param [in] period Period for periodic timers. 0 for one-shot timers.
+//! @return FX_TIMER_OK in case of success, error code otherwise.
+//!
+int
+fx_timer_internal_set_rel(
+    fx_timer_internal_t* timer,
+    uint32_t delay,
+    uint32_t period)
+{
+    uint32_t ticks;
+    fx_lock_intr_state_t state;
+    fx_spl_raise_to_sync_from_any(&state);
+    ticks = fx_timer_internal_ticks + fx_timer_wheel_pending;
+    fx_spl_lower_to_any_from_sync(state);
+    return fx_timer_internal_set_abs(timer, ticks + delay, period);
+}
+
+//!
+//! Gets number of ticks which may elapse without expiration of any timer.
+//! It is used by the HAL in tickless mode to program the hardware timer.
+//! Cascade of non-empty slot is also considered as timer event, so, returned 
+//! value may be less than time remaining until the nearest deadline. If there
+//! are ticks which are not yet processed by the DPC, idle mode is not allowed.
+//! @param [in] max Maximum number of ticks which may be skipped by hardware.
+//! @return Number of ticks which may be skipped (it does not exceed max).
+//!
+uint32_t
+fx_tick_get_idle(uint32_t max)
+{
+    uint32_t idle = max;
+    unsigned int level, i;
+    fx_lock_intr_state_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+
+    if (fx_timer_wheel_pending)
+    {
+        idle = 0;
+    }
+
+    for (level = 0; idle && level < FX_TIMER_WHEEL_LEVELS; ++level)
+    {
+        const unsigned int shift = level * FX_TIMER_WHEEL_SLOT_BITS;
+        const uint32_t base = fx_timer_internal_ticks >> shift;
+
+        //
+        // Find nearest non-empty slot at this level. Slot at level 0 is 
+        // processed when the tick counter reaches it, slots at upper levels
+        // are cascaded when the counter reaches the start of the slot.
+        //
+        for (i = 1; i <= FX_TIMER_WHEEL_SLOTS; ++i)
+        {
+            const uint32_t t = (base + i) << shift;
+
+            if (!rtl_list_empty(
+                &fx_timer_wheel[level][fx_timer_wheel_index(t, level)]))
+            {
+                idle = lang_min(t - fx_timer_internal_ticks - 1, idle);
+                break;
+            }
+        }
+    }
+
+    fx_spl_lower_to_any_from_sync(state);
+    return idle;
+}
+
+//!
+//! Credits ticks skipped during tickless idle to the tick counter in one step.
+//! Since no slots are processed or cascaded during skipped ticks, there is no 
+//! need to touch the wheel.
+//! @param [in] ticks Number of elapsed ticks. It must not exceed value 
+//! returned by preceding call to fx_tick_get_idle, so no timers may expire.
+//!
+void
+fx_tick_advance(uint32_t ticks)
+{
+    fx_lock_intr_state_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+    fx_timer_internal_ticks += ticks;
+    trace_increment_tick(fx_timer_internal_ticks);
+    fx_spl_lower_to_any_from_sync(state);
+}
+
+//
+// Timer DPC. It advances the wheel by one tick for each pending tick.
+// Requests issued before the DPC is handled are merged into single one, so,
+// it may process several ticks at once.
+// @remark SPL = DISPATCH
+//
+static void
+fx_timer_wheel_dpc_handler(fx_dpc_t* dpc, void* arg)
+{
+    rtl_list_t* list;
+    unsigned int level;
+    uint32_t ticks;
+    fx_lock_intr_state_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+
+    while (fx_timer_wheel_pending)
+    {
+        --fx_timer_wheel_pending;
+        ticks = ++fx_timer_internal_ticks;
+
+        //
+        // Cascade upper levels whose slot boundary is reached at this tick. 
+        // Lower levels must be cascaded first, since timers from upper levels
+        // may only be moved into slots which are not yet processed.
+        //
+        for (level = 1; level < FX_TIMER_WHEEL_LEVELS; ++level)
+        {
+            if (fx_timer_wheel_index(ticks, level - 1) != 0)
+            {
+                break;
+            }
+
+            _fx_timer_cascade(level, &state);
+        }
+
+        //
+        // All timers in current slot of level 0 are expired. Timers armed 
+        // from callbacks are never inserted into this slot, so loop is finite.
+        //
+        list = &fx_timer_wheel[0][fx_timer_wheel_index(ticks, 0)];
+
+        while (!rtl_list_empty(list))
+        {
+            fx_timer_internal_t* item = rtl_list_entry(
+                rtl_list_first(list),
+                fx_timer_internal_t,
+                link
+            );
+
+            rtl_list_remove(&item->link);
+
+            if (item->period)
+            {
+                item->timeout += item->period;
+                _fx_timer_insert(item, ticks + 1);
+            }
+
+            fx_spl_lower_to_any_from_sync(state);
+            (item->callback)(item->callback_arg);
+            fx_spl_raise_to_sync_from_any(&state);
+        }
+    }
+
+    fx_spl_lower_to_any_from_sync(state);
+}
+
+//!
+//! Tick handler is called by the HAL.
+//! It only counts the tick, the wheel is advanced by the DPC.
+//!
+void
+fx_tick_handler(void)
+{
+    fx_lock_intr_state_t state;
+
+    fx_spl_raise_to_sync_from_any(&state);
+    ++fx_timer_wheel_pending;
+    trace_increment_tick(fx_timer_internal_ticks + fx_timer_wheel_pending);
+    fx_spl_lower_to_any_from_sync(state);
+
+    (void) fx_dpc_request(
+        &fx_timer_wheel_dpc, 
+        fx_timer_wheel_dpc_handler, 
+        NULL
+    );
+}
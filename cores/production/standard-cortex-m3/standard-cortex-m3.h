@@ -38,6 +38,10 @@
 #include FX_INTERFACE(FX_SEM)
 #include FX_INTERFACE(FX_MUTEX)
 #include FX_INTERFACE(FX_MSGQ)
+#include FX_INTERFACE(FX_RING)
+#include FX_INTERFACE(FX_STREAM)
+#include FX_INTERFACE(FX_SLOT)
+#include FX_INTERFACE(FX_MAILBOX)
 #include FX_INTERFACE(FX_BLOCK_POOL)
 #include FX_INTERFACE(FX_EV_FLAGS)
 #include FX_INTERFACE(FX_RWLOCK)